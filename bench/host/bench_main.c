@@ -0,0 +1,502 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "dht22.h"
+#include "hx711.h"
+#include "scheduler.h"
+#include "hardware/gpio.h"
+#include "weight_filter.h"
+#include "telemetry.h"
+#include "mock_hw.h"
+#include "waveforms.h"
+
+// Parâmetros dos benchmarks
+#define BENCH_DHT22_PIN 16
+#define BENCH_DHT22_OUTSIDE_PIN 17     // Segundo sensor de dht22_read_all()
+#define BENCH_HX711_DT_PIN 2
+#define BENCH_HX711_SCK_PIN 3
+#define BENCH_MOTION_PIN 20             // Sensor de movimento de scheduler_wake_on_gpio()
+#define BENCH_DHT22_READS 2000         // Leituras por cenário e modo de captura
+#define BENCH_DHT22_WAVES 64           // Formas de onda distintas por cenário (variação)
+#define BENCH_RAW_SAMPLES 4096         // Leituras brutas sintéticas do HX711
+#define BENCH_RAW_ROUNDS 256           // Passadas sobre as leituras brutas
+#define BENCH_BATCH_SIZE 64            // Lote de hx711_convert_batch()
+#define BENCH_TELEMETRY_RECORDS 10     // Registros por lote de telemetria
+#define BENCH_TELEMETRY_ROUNDS 100000  // Lotes codificados
+
+// Calibração sintética: tara em 84000 contagens, 1 kg = 420000 contagens
+#define BENCH_TARE_READING 84000
+#define BENCH_CAL_READING (BENCH_TARE_READING + 420000)
+#define BENCH_CAL_WEIGHT 1000.0f
+
+// Impede que o compilador elimine os laços medidos
+static volatile int64_t bench_sink;
+
+static int32_t bench_raw[BENCH_RAW_SAMPLES];
+static mock_waveform_t bench_waves[BENCH_DHT22_WAVES];
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void bench_report(const char *name, uint64_t elapsed_ns, uint64_t ops) {
+    double ns_per_op = (double)elapsed_ns / (double)ops;
+    printf("%-34s %10.1f ns/op %14.0f op/s\n", name, ns_per_op, 1e9 / ns_per_op);
+}
+
+// Lê um cenário repetidamente e confere os valores decodificados
+static bool bench_dht22(const waveform_scenario_t *scenario, dht22_capture_t capture) {
+    dht22_t dev;
+    dht22_signal_t signal;
+    uint32_t seed = 1;
+    uint32_t ok = 0;
+    uint32_t min_margin = UINT32_MAX;
+    char name[64];
+
+    mock_reset();
+    for (int i = 0; i < BENCH_DHT22_WAVES; i++) {
+        waveform_build(scenario, &seed, &bench_waves[i]);
+    }
+    if (dht22_init(&dev, BENCH_DHT22_PIN, capture) != DHT22_OK) {
+        printf("dht22: falha ao inicializar\n");
+        return false;
+    }
+    dht22_set_max_retries(&dev, 0); // Cada falha de decodificação deve aparecer
+    if (scenario->dht11_frame) {
+        dht22_set_profile(&dev, DHT22_PROFILE_DHT11);
+    }
+
+    uint64_t start = bench_now_ns();
+    for (int i = 0; i < BENCH_DHT22_READS; i++) {
+        float temperature, humidity;
+        mock_set_waveform(BENCH_DHT22_PIN, &bench_waves[i % BENCH_DHT22_WAVES]);
+
+        if (dht22_read(&dev, &temperature, &humidity) == DHT22_OK &&
+            fabsf(temperature - scenario->temperature_x10 * 0.1f) < 0.05f &&
+            fabsf(humidity - scenario->humidity_x10 * 0.1f) < 0.05f) {
+            ok++;
+        }
+        dht22_get_signal(&dev, &signal);
+        if (signal.margin_us < min_margin) min_margin = signal.margin_us;
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    snprintf(name, sizeof(name), "dht22 %s/%s", capture == DHT22_CAPTURE_PIO ? "pio" : "gpio", scenario->name);
+    bench_report(name, elapsed, BENCH_DHT22_READS);
+    printf("%-34s ok %u/%u, margem minima %u us\n", "", (unsigned)ok, (unsigned)BENCH_DHT22_READS,
+           (unsigned)min_margin);
+    return ok == BENCH_DHT22_READS;
+}
+
+// Confere dht22_read_cached(): sem dado antes da primeira leitura; depois, o último
+// valor válido e sua idade, devolvidos sem esperar o intervalo mínimo do sensor
+static bool bench_dht22_cached(const waveform_scenario_t *scenario) {
+    dht22_t dev = {0};
+    float temperature, humidity, cached_temperature, cached_humidity;
+    uint32_t seed = 1, age_ms = UINT32_MAX;
+    bool ok = true;
+
+    mock_reset();
+    waveform_build(scenario, &seed, &bench_waves[0]);
+    mock_set_waveform(BENCH_DHT22_PIN, &bench_waves[0]);
+    ok &= dht22_read_cached(&dev, &cached_temperature, &cached_humidity, &age_ms) == DHT22_ERROR_NOT_INITIALIZED;
+    ok &= dht22_init(&dev, BENCH_DHT22_PIN, DHT22_CAPTURE_GPIO) == DHT22_OK;
+    dht22_set_max_retries(&dev, 0);
+    ok &= dht22_read_cached(&dev, &cached_temperature, &cached_humidity, &age_ms) == DHT22_ERROR_NO_DATA;
+
+    ok &= dht22_read(&dev, &temperature, &humidity) == DHT22_OK;
+    sleep_ms(1500); // Ainda dentro de DHT22_MIN_INTERVAL_MS: dht22_read() esperaria o restante
+
+    // A idade máxima vencida não bloqueia: no modo GPIO nada é lido em segundo plano
+    dht22_set_max_age(&dev, 1000);
+    uint64_t before_us = mock_time_us();
+    ok &= dht22_read_cached(&dev, &cached_temperature, &cached_humidity, &age_ms) == DHT22_OK;
+    ok &= mock_time_us() == before_us && age_ms >= 1500 && age_ms < DHT22_MIN_INTERVAL_MS;
+    ok &= cached_temperature == temperature && cached_humidity == humidity;
+    ok &= dht22_read_cached(&dev, &cached_temperature, &cached_humidity, NULL) == DHT22_OK;
+
+    printf("%-34s %s\n", "dht22_read_cached", ok ? "ok" : "FALHA");
+    return ok;
+}
+
+// Confere dht22_read_all() com dois sensores em pinos diferentes: cada instância
+// recebe o próprio quadro, e a falha de uma não apaga o resultado da outra
+static bool bench_dht22_read_all(const waveform_scenario_t *inside_scenario,
+                                 const waveform_scenario_t *outside_scenario) {
+    dht22_t inside, outside;
+    dht22_t *const devs[] = {&inside, &outside};
+    float temperature, humidity;
+    uint32_t seed = 1;
+    bool ok = true;
+
+    mock_reset();
+    waveform_build(inside_scenario, &seed, &bench_waves[0]);
+    waveform_build(outside_scenario, &seed, &bench_waves[1]);
+    mock_set_waveform(BENCH_DHT22_PIN, &bench_waves[0]);
+    mock_set_waveform(BENCH_DHT22_OUTSIDE_PIN, &bench_waves[1]);
+    ok &= dht22_init(&inside, BENCH_DHT22_PIN, DHT22_CAPTURE_GPIO) == DHT22_OK;
+    ok &= dht22_init(&outside, BENCH_DHT22_OUTSIDE_PIN, DHT22_CAPTURE_GPIO) == DHT22_OK;
+    dht22_set_max_retries(&inside, 0);
+    dht22_set_max_retries(&outside, 0);
+
+    ok &= dht22_read_all(devs, count_of(devs)) == DHT22_OK;
+    ok &= dht22_get_result(&inside, &temperature, &humidity) == DHT22_OK &&
+          fabsf(temperature - inside_scenario->temperature_x10 * 0.1f) < 0.05f &&
+          fabsf(humidity - inside_scenario->humidity_x10 * 0.1f) < 0.05f;
+    ok &= dht22_get_result(&outside, &temperature, &humidity) == DHT22_OK &&
+          fabsf(temperature - outside_scenario->temperature_x10 * 0.1f) < 0.05f &&
+          fabsf(humidity - outside_scenario->humidity_x10 * 0.1f) < 0.05f;
+
+    // Sensor externo desconectado (linha sempre em HIGH): o erro dele é o retorno
+    sleep_ms(DHT22_MIN_INTERVAL_MS);
+    mock_set_waveform(BENCH_DHT22_OUTSIDE_PIN, NULL);
+    int result = dht22_read_all(devs, count_of(devs));
+    ok &= result != DHT22_OK && dht22_get_result(&outside, &temperature, &humidity) == result;
+    ok &= dht22_get_result(&inside, &temperature, &humidity) == DHT22_OK;
+
+    printf("%-34s %s\n", "dht22_read_all (2 sensores gpio)", ok ? "ok" : "FALHA");
+    return ok;
+}
+
+static void bench_calculate_weight(void) {
+    float sum = 0.0f;
+    uint64_t start = bench_now_ns();
+    for (int round = 0; round < BENCH_RAW_ROUNDS; round++) {
+        for (int i = 0; i < BENCH_RAW_SAMPLES; i++) {
+            sum += calculate_weight(bench_raw[i]);
+        }
+    }
+    bench_report("calculate_weight", bench_now_ns() - start, (uint64_t)BENCH_RAW_ROUNDS * BENCH_RAW_SAMPLES);
+    bench_sink = (int64_t)sum;
+}
+
+static void bench_calculate_weight_mg(void) {
+    int64_t sum = 0;
+    uint64_t start = bench_now_ns();
+    for (int round = 0; round < BENCH_RAW_ROUNDS; round++) {
+        for (int i = 0; i < BENCH_RAW_SAMPLES; i++) {
+            sum += calculate_weight_mg(bench_raw[i]);
+        }
+    }
+    bench_report("calculate_weight_mg", bench_now_ns() - start, (uint64_t)BENCH_RAW_ROUNDS * BENCH_RAW_SAMPLES);
+    bench_sink = sum;
+}
+
+static void bench_convert_batch(void) {
+    int32_t out[BENCH_BATCH_SIZE];
+    int64_t sum = 0;
+    uint64_t start = bench_now_ns();
+    for (int round = 0; round < BENCH_RAW_ROUNDS; round++) {
+        for (int i = 0; i < BENCH_RAW_SAMPLES; i += BENCH_BATCH_SIZE) {
+            hx711_convert_batch(&bench_raw[i], out, BENCH_BATCH_SIZE);
+            sum += out[BENCH_BATCH_SIZE - 1];
+        }
+    }
+    bench_report("hx711_convert_batch (por amostra)", bench_now_ns() - start,
+                 (uint64_t)BENCH_RAW_ROUNDS * BENCH_RAW_SAMPLES);
+    bench_sink = sum;
+}
+
+// Fonte sintética do HX711: percorre um vetor de leituras e conta as conversões
+typedef struct {
+    const int32_t *values;
+    uint32_t count;
+    uint32_t produced;
+} bench_hx711_source_t;
+
+static int32_t bench_hx711_next(void *context) {
+    bench_hx711_source_t *source = context;
+    return source->values[source->produced++ % source->count];
+}
+
+// Leitura que deve devolver a conversão mais recente da fonte, após descartar skip conversões
+static bool bench_hx711_expect(bench_hx711_source_t *source, uint32_t skip) {
+    uint32_t before = source->produced;
+    int32_t raw = hx711_read(BENCH_HX711_DT_PIN, BENCH_HX711_SCK_PIN);
+    return source->produced - before == 1 + skip &&
+           raw == source->values[(source->produced - 1) % source->count];
+}
+
+// Confere hx711_read() sobre o PIO simulado: extensão de sinal dos 24 bits,
+// acomodação após a troca de ganho e leitura recusada em power-down
+static bool bench_hx711_driver(void) {
+    static const int32_t values[] = {0x7FFFFF, -0x800000, -1, 123456, 0, -420000};
+    bench_hx711_source_t source = {values, count_of(values), 0};
+    bool ok = true;
+
+    mock_reset();
+    mock_set_hx711_source(bench_hx711_next, &source);
+
+    // Uma conversão por leitura, na ordem da fonte (a primeira leitura inicializa o driver)
+    for (uint32_t i = 0; i < count_of(values); i++) {
+        ok &= bench_hx711_expect(&source, 0);
+    }
+
+    // O novo ganho chega ao PIO e as conversões de acomodação são descartadas
+    ok &= hx711_set_gain(HX711_GAIN_B32) == HX711_OK && hx711_get_gain() == HX711_GAIN_B32;
+    ok &= bench_hx711_expect(&source, HX711_SETTLE_DISCARD);
+    ok &= mock_hx711_gain() == HX711_GAIN_B32;
+    ok &= hx711_set_gain((hx711_gain_t)3) == HX711_ERROR_INVALID_PARAM && hx711_get_gain() == HX711_GAIN_B32;
+
+    // Desligado: nenhuma conversão; o ganho trocado nesse estado vai ao PIO ao religar
+    ok &= hx711_power_down() == HX711_OK && hx711_is_powered_down();
+    uint32_t before = source.produced;
+    ok &= hx711_read(BENCH_HX711_DT_PIN, BENCH_HX711_SCK_PIN) == HX711_READ_ERROR && source.produced == before;
+    ok &= hx711_set_gain(HX711_GAIN_A64) == HX711_OK && mock_hx711_gain() == HX711_GAIN_B32;
+    ok &= hx711_power_up() == HX711_OK && !hx711_is_powered_down();
+    before = source.produced;
+    int32_t raw = hx711_read(BENCH_HX711_DT_PIN, BENCH_HX711_SCK_PIN);
+    ok &= source.produced - before > 1 && raw == values[(source.produced - 1) % count_of(values)];
+    ok &= mock_hx711_gain() == HX711_GAIN_A64;
+
+    ok &= hx711_set_gain(HX711_GAIN_A128) == HX711_OK;
+    ok &= bench_hx711_expect(&source, HX711_SETTLE_DISCARD); // Nenhuma acomodação pendente para os próximos casos
+    mock_set_hx711_source(NULL, NULL);
+    printf("%-34s %s\n", "hx711_read (fonte simulada)", ok ? "ok" : "FALHA");
+    return ok;
+}
+
+// Confere weight_read_stable(): término antecipado com o peso parado, limite de
+// leituras com o peso variando e erro com o HX711 desligado
+static bool bench_read_stable(void) {
+    static const int32_t quiet[] = {84040, 83960, 84010, 84090, 83920, 84000, 84060};
+    int32_t ramp[64]; // Peso ainda variando: 300 contagens por leitura, sempre além da tolerância
+    bench_hx711_source_t source = {quiet, count_of(quiet), 0};
+    weight_filter_t filter;
+    weight_settle_t settle;
+    int32_t reading;
+    bool ok = true;
+
+    mock_reset();
+    mock_set_hx711_source(bench_hx711_next, &source);
+
+    // Ruído de ±90 contagens: estável após as 8 estimativas mínimas, bem antes do limite
+    weight_filter_init(&filter, WEIGHT_FILTER_MEDIAN, 5);
+    weight_settle_init(&settle, 200, 8);
+    ok &= weight_read_stable(BENCH_HX711_DT_PIN, BENCH_HX711_SCK_PIN, &filter, &settle, 64, &reading) == WEIGHT_FILTER_OK;
+    ok &= source.produced == 8 && reading >= 83920 && reading <= 84090;
+
+    for (uint32_t i = 0; i < count_of(ramp); i++) {
+        ramp[i] = 84000 + 300 * (int32_t)i;
+    }
+    source = (bench_hx711_source_t){ramp, count_of(ramp), 0};
+    weight_filter_init(&filter, WEIGHT_FILTER_MEDIAN, 5);
+    weight_settle_init(&settle, 200, 8);
+    ok &= weight_read_stable(BENCH_HX711_DT_PIN, BENCH_HX711_SCK_PIN, &filter, &settle, 64, &reading) ==
+          WEIGHT_FILTER_ERROR_NOT_SETTLED;
+    ok &= source.produced == 64 && reading == weight_filter_value(&filter);
+
+    hx711_power_down();
+    ok &= weight_read_stable(BENCH_HX711_DT_PIN, BENCH_HX711_SCK_PIN, &filter, &settle, 64, &reading) ==
+          WEIGHT_FILTER_ERROR_READ;
+    hx711_power_up();
+
+    mock_set_hx711_source(NULL, NULL);
+    printf("%-34s %s\n", "weight_read_stable", ok ? "ok" : "FALHA");
+    return ok;
+}
+
+static void bench_filter(const char *name, weight_filter_type_t type, uint32_t param) {
+    weight_filter_t filter;
+    int64_t sum = 0;
+
+    weight_filter_init(&filter, type, param);
+    uint64_t start = bench_now_ns();
+    for (int round = 0; round < BENCH_RAW_ROUNDS; round++) {
+        for (int i = 0; i < BENCH_RAW_SAMPLES; i++) {
+            sum += weight_filter_update(&filter, bench_raw[i]);
+        }
+    }
+    bench_report(name, bench_now_ns() - start, (uint64_t)BENCH_RAW_ROUNDS * BENCH_RAW_SAMPLES);
+    bench_sink = sum;
+}
+
+static void bench_settle(void) {
+    weight_settle_t settle;
+    int64_t sum = 0;
+
+    weight_settle_init(&settle, 200, 8);
+    uint64_t start = bench_now_ns();
+    for (int round = 0; round < BENCH_RAW_ROUNDS; round++) {
+        for (int i = 0; i < BENCH_RAW_SAMPLES; i++) {
+            sum += weight_settle_update(&settle, bench_raw[i]);
+        }
+    }
+    bench_report("weight_settle_update", bench_now_ns() - start, (uint64_t)BENCH_RAW_ROUNDS * BENCH_RAW_SAMPLES);
+    bench_sink = sum;
+}
+
+// Tarefa do escalonador: conta as execuções
+static void bench_count_task(void *context) {
+    (*(uint32_t *)context)++;
+}
+
+// Confere scheduler_wake_on_gpio(): só a borda associada dispara a tarefa sob
+// demanda, sem antecipar a periódica, e o evento é reconhecido no tratador
+static bool bench_scheduler_gpio(void) {
+    scheduler_t scheduler;
+    uint32_t periodic_runs = 0, motion_runs = 0;
+    bool ok = true;
+
+    mock_reset();
+    scheduler_init(&scheduler);
+    int periodic = scheduler_add(&scheduler, bench_count_task, &periodic_runs, 1000);
+    int motion = scheduler_add(&scheduler, bench_count_task, &motion_runs, SCHEDULER_ON_DEMAND);
+    ok &= periodic >= 0 && motion >= 0;
+    ok &= scheduler_wake_on_gpio(&scheduler, SCHEDULER_MAX_TASKS, BENCH_MOTION_PIN, GPIO_IRQ_EDGE_RISE) ==
+          SCHEDULER_ERROR_INVALID_TASK;
+    ok &= scheduler_wake_on_gpio(&scheduler, motion, BENCH_MOTION_PIN, GPIO_IRQ_EDGE_RISE) == SCHEDULER_OK;
+
+    // A tarefa periódica vence ao ser registrada; a próxima fica 1 s adiante
+    ok &= scheduler_run_pending(&scheduler) == 1 && periodic_runs == 1 && motion_runs == 0;
+    sleep_ms(100);
+    absolute_time_t periodic_deadline = scheduler_next_deadline(&scheduler);
+    ok &= absolute_time_diff_us(get_absolute_time(), periodic_deadline) == 900000;
+
+    // Borda não monitorada: nada muda
+    mock_gpio_edge(BENCH_MOTION_PIN, GPIO_IRQ_EDGE_FALL);
+    ok &= scheduler_next_deadline(&scheduler) == periodic_deadline && scheduler_run_pending(&scheduler) == 0;
+
+    // Movimento: o escalonador acorda já e roda apenas a tarefa sob demanda
+    mock_gpio_edge(BENCH_MOTION_PIN, GPIO_IRQ_EDGE_RISE);
+    ok &= gpio_get_irq_event_mask(BENCH_MOTION_PIN) == 0;
+    ok &= scheduler_next_deadline(&scheduler) == get_absolute_time();
+    ok &= scheduler_run_pending(&scheduler) == 1 && motion_runs == 1 && periodic_runs == 1;
+    ok &= scheduler_next_deadline(&scheduler) == periodic_deadline;
+
+    printf("%-34s %s\n", "scheduler_wake_on_gpio", ok ? "ok" : "FALHA");
+    return ok;
+}
+
+// Registro sintético: peso com ruído, temperatura e umidade variando devagar
+static void bench_telemetry_record(uint32_t i, telemetry_record_t *record) {
+    record->timestamp_ms = 1000 * i;
+    record->weight_mg = 1000000 + bench_raw[i % BENCH_RAW_SAMPLES] % 2000;
+    record->inside_temperature_x10 = (int16_t)(234 + (i / 8) % 3);
+    record->inside_humidity_x10 = (uint16_t)(652 - (i / 5) % 4);
+    record->outside_temperature_x10 = (int16_t)(-21 + (i / 16) % 2);
+    record->outside_humidity_x10 = 805;
+    record->status = TELEMETRY_STATUS_WEIGHT_VALID | TELEMETRY_STATUS_INSIDE_VALID | TELEMETRY_STATUS_OUTSIDE_VALID;
+}
+
+// Compara o lote binário com o relatório em texto equivalente; retorna false se a ida e volta
+// do lote ou do retrato de métricas falhar
+static bool bench_telemetry(void) {
+    telemetry_record_t records[BENCH_TELEMETRY_RECORDS];
+    telemetry_record_t decoded[BENCH_TELEMETRY_RECORDS];
+    uint8_t batch[TELEMETRY_HEADER_SIZE + BENCH_TELEMETRY_RECORDS * TELEMETRY_RECORD_MAX_ENCODED];
+    telemetry_encoder_t encoder;
+    char text[160];
+    uint32_t length = 0, text_length = 0, count = 0;
+
+    for (uint32_t i = 0; i < BENCH_TELEMETRY_RECORDS; i++) {
+        bench_telemetry_record(i, &records[i]);
+    }
+
+    uint64_t start = bench_now_ns();
+    for (int round = 0; round < BENCH_TELEMETRY_ROUNDS; round++) {
+        telemetry_encoder_init(&encoder, batch, sizeof(batch));
+        for (uint32_t i = 0; i < BENCH_TELEMETRY_RECORDS; i++) {
+            telemetry_encoder_add(&encoder, &records[i]);
+        }
+        length = telemetry_encoder_finish(&encoder);
+    }
+    bench_report("telemetria binaria (por registro)", bench_now_ns() - start,
+                 (uint64_t)BENCH_TELEMETRY_ROUNDS * BENCH_TELEMETRY_RECORDS);
+
+    // Relatório em texto anterior, com os valores em float
+    start = bench_now_ns();
+    for (int round = 0; round < BENCH_TELEMETRY_ROUNDS; round++) {
+        text_length = 0;
+        for (uint32_t i = 0; i < BENCH_TELEMETRY_RECORDS; i++) {
+            const telemetry_record_t *r = &records[i];
+            text_length += (uint32_t)snprintf(text, sizeof(text),
+                "peso: %.3f g | interno: %.1f C %.1f %% | externo: %.1f C %.1f %% | descartes: %u\n",
+                r->weight_mg * 0.001f, r->inside_temperature_x10 * 0.1f, r->inside_humidity_x10 * 0.1f,
+                r->outside_temperature_x10 * 0.1f, r->outside_humidity_x10 * 0.1f, 0u);
+        }
+    }
+    bench_report("relatorio em texto (por registro)", bench_now_ns() - start,
+                 (uint64_t)BENCH_TELEMETRY_ROUNDS * BENCH_TELEMETRY_RECORDS);
+    printf("%-34s %u bytes binario, %u bytes texto (%.1fx)\n", "", (unsigned)length, (unsigned)text_length,
+           (double)text_length / length);
+
+    if (telemetry_decode(batch, length, decoded, BENCH_TELEMETRY_RECORDS, &count) != TELEMETRY_OK ||
+        count != BENCH_TELEMETRY_RECORDS || memcmp(decoded, records, sizeof(records)) != 0) {
+        printf("FALHA: lote de telemetria decodificado incorretamente\n");
+        return false;
+    }
+
+    // Retrato de métricas com contadores de vários tamanhos de varint
+    metrics_snapshot_t snapshot, snapshot_decoded;
+    uint8_t encoded[TELEMETRY_METRICS_MAX_ENCODED];
+    for (uint32_t c = 0; c < METRICS_COUNTER_COUNT; c++) {
+        metrics_add((metrics_counter_t)c, 1u << (2 * c));
+    }
+    metrics_max(METRICS_QUEUE_HIGH_WATER, 200);
+    metrics_max(METRICS_QUEUE_HIGH_WATER, 100); // Não reduz a marca de máximo
+    metrics_snapshot(&snapshot);
+
+    uint32_t metrics_length = telemetry_encode_metrics(&snapshot, encoded, sizeof(encoded));
+    printf("%-34s %u bytes\n", "retrato de metricas", (unsigned)metrics_length);
+    if (metrics_length == 0 || snapshot.counters[METRICS_QUEUE_HIGH_WATER] < 200 ||
+        telemetry_decode_metrics(encoded, metrics_length, &snapshot_decoded) != TELEMETRY_OK ||
+        memcmp(&snapshot_decoded, &snapshot, sizeof(snapshot)) != 0) {
+        printf("FALHA: retrato de metricas decodificado incorretamente\n");
+        return false;
+    }
+    return true;
+}
+
+int main(void) {
+    bool decode_ok = true;
+
+    printf("== DHT22: captura e decodificacao sobre formas de onda sinteticas ==\n");
+    for (uint32_t i = 0; i < waveform_scenario_count; i++) {
+        decode_ok &= bench_dht22(&waveform_scenarios[i], DHT22_CAPTURE_GPIO);
+        decode_ok &= bench_dht22(&waveform_scenarios[i], DHT22_CAPTURE_PIO);
+    }
+    decode_ok &= bench_dht22_cached(&waveform_scenarios[0]);
+    decode_ok &= bench_dht22_read_all(&waveform_scenarios[0], &waveform_scenarios[1]);
+
+    // Leituras brutas: peso em torno de 1 kg com ruído de ±2048 contagens
+    uint32_t seed = 7;
+    for (int i = 0; i < BENCH_RAW_SAMPLES; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        bench_raw[i] = BENCH_CAL_READING + (int32_t)((seed >> 8) % 4096) - 2048;
+    }
+    tare_hx711(BENCH_TARE_READING);
+    calibrate_hx711(BENCH_CAL_READING, BENCH_CAL_WEIGHT);
+
+    printf("\n== HX711: conversao ==\n");
+    bench_calculate_weight();
+    bench_calculate_weight_mg();
+    bench_convert_batch();
+
+    printf("\n== HX711: driver sobre o PIO simulado ==\n");
+    decode_ok &= bench_hx711_driver();
+
+    printf("\n== Filtros de peso ==\n");
+    bench_filter("media movel (16)", WEIGHT_FILTER_MOVING_AVERAGE, 16);
+    bench_filter("mediana (5)", WEIGHT_FILTER_MEDIAN, 5);
+    bench_filter("mediana (31)", WEIGHT_FILTER_MEDIAN, 31);
+    bench_filter("iir (shift 4)", WEIGHT_FILTER_IIR, 4);
+    bench_settle();
+    decode_ok &= bench_read_stable();
+
+    printf("\n== Escalonador ==\n");
+    decode_ok &= bench_scheduler_gpio();
+
+    printf("\n== Telemetria ==\n");
+    decode_ok &= bench_telemetry();
+
+    if (!decode_ok) {
+        printf("\nFALHA: resultado incorreto (DHT22, HX711, escalonador ou telemetria)\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
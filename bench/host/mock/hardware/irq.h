@@ -0,0 +1,16 @@
+#ifndef MOCK_HARDWARE_IRQ_H
+#define MOCK_HARDWARE_IRQ_H
+
+// Interrupções simuladas: tratadores são registrados, mas só os de GPIO são chamados (mock_gpio_edge())
+
+#include "pico/stdlib.h"
+
+typedef void (*irq_handler_t)(void);
+
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+#define IO_IRQ_BANK0 13
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority);
+void irq_set_enabled(uint num, bool enabled);
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef MOCK_HARDWARE_SYNC_H
+#define MOCK_HARDWARE_SYNC_H
+
+// Barreiras e eventos do Cortex-M0+ mapeados para o host
+
+#include <stdint.h>
+
+#define __mem_fence_acquire() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define __mem_fence_release() __atomic_thread_fence(__ATOMIC_RELEASE)
+#define __sev() ((void)0)
+#define __wfe() ((void)0)
+
+// Host sem interrupções: nada a salvar
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef MOCK_HX711_PIO_H
+#define MOCK_HX711_PIO_H
+
+// Substitui o cabeçalho gerado por pioasm a partir de hx711.pio
+
+#include "hardware/pio.h"
+
+extern const pio_program_t hx711_program;
+
+static inline void hx711_program_init(PIO pio, uint sm, uint offset, uint pin_dt, uint pin_sck) {
+    (void)pio; (void)sm; (void)offset; (void)pin_dt; (void)pin_sck;
+}
+
+#endif
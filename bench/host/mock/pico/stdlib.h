@@ -0,0 +1,22 @@
+#ifndef MOCK_PICO_STDLIB_H
+#define MOCK_PICO_STDLIB_H
+
+// Subconjunto de pico/stdlib.h para a compilação no host
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pico/time.h"
+
+typedef unsigned int uint;
+
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#define PICO_ERROR_TIMEOUT -1
+
+static inline void tight_loop_contents(void) {}
+static inline uint get_core_num(void) { return 0; }
+
+bool stdio_init_all(void);
+int getchar_timeout_us(uint32_t timeout_us);
+
+#endif
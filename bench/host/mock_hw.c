@@ -0,0 +1,324 @@
+#include "mock_hw.h"
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include <string.h>
+
+// Número de canais DMA e máquinas de estados por bloco PIO
+#define MOCK_NUM_DMA_CHANNELS 12
+#define MOCK_NUM_SMS 4
+
+// Estado de um pino simulado
+typedef struct {
+    bool output;                 // Direção (true = saída)
+    bool value;                  // Nível escrito pelo host
+    const mock_waveform_t *wave; // Resposta do sensor ligado ao pino
+    bool playing;                // Forma de onda em reprodução
+    uint64_t release_us;         // Instante em que o host liberou a linha
+    uint32_t segment;            // Segmento atual da reprodução
+    uint64_t segment_end_us;     // Fim do segmento atual
+    uint32_t irq_enabled;        // Bordas que geram interrupção
+    uint32_t irq_pending;        // Bordas ainda não reconhecidas
+    irq_handler_t irq_handler;   // Tratador bruto de gpio_add_raw_irq_handler()
+} mock_gpio_t;
+
+static uint64_t mock_now_us;
+static mock_gpio_t mock_gpios[MOCK_NUM_GPIOS];
+static uint32_t mock_last_pindirs_pin;
+static bool mock_sm_claimed[2][MOCK_NUM_SMS];
+static bool mock_dma_claimed[MOCK_NUM_DMA_CHANNELS];
+static dma_channel_hw_t mock_dma_hw[MOCK_NUM_DMA_CHANNELS];
+static uint32_t mock_rx_level;
+static uint32_t mock_tx_level[2][MOCK_NUM_SMS]; // Ganhos (HX711) ou pulsos de início (DHT22) na TX FIFO
+static uint32_t mock_tx_last[2][MOCK_NUM_SMS];  // Última palavra escrita na TX FIFO
+static uint32_t mock_hx711_gain_applied;        // Ganho retirado pela última conversão do HX711
+static uint64_t mock_next_conversion_us;
+static mock_hx711_source_t mock_hx711_source;
+static void *mock_hx711_context;
+
+pio_hw_t mock_pio0, mock_pio1;
+const pio_program_t dht22_program = {NULL, 0, -1};
+const pio_program_t hx711_program = {NULL, 0, -1};
+const absolute_time_t at_the_end_of_time = INT64_MAX; // Como no SDK: diferenças com ele não estouram
+
+// Inicia o relógio em 1 s: o driver DHT22 trata last_read_time_ms == 0 como "nunca lido"
+void mock_reset(void) {
+    mock_now_us = 1000000;
+    memset(mock_gpios, 0, sizeof(mock_gpios));
+    memset(mock_sm_claimed, 0, sizeof(mock_sm_claimed));
+    memset(mock_dma_claimed, 0, sizeof(mock_dma_claimed));
+    mock_rx_level = 0;
+    memset(mock_tx_level, 0, sizeof(mock_tx_level));
+    memset(mock_tx_last, 0, sizeof(mock_tx_last));
+    mock_hx711_gain_applied = 0;
+    mock_next_conversion_us = mock_now_us;
+    mock_hx711_source = NULL;
+    mock_hx711_context = NULL;
+}
+
+void mock_set_waveform(uint32_t pin, const mock_waveform_t *wave) {
+    mock_gpios[pin].wave = wave;
+    mock_gpios[pin].playing = false;
+}
+
+void mock_set_hx711_source(mock_hx711_source_t source, void *context) {
+    mock_hx711_source = source;
+    mock_hx711_context = context;
+}
+
+void mock_gpio_edge(uint32_t pin, uint32_t events) {
+    mock_gpio_t *g = &mock_gpios[pin];
+    g->irq_pending |= events & g->irq_enabled;
+    if (g->irq_pending && g->irq_handler != NULL) {
+        g->irq_handler();
+    }
+}
+
+uint64_t mock_time_us(void) {
+    return mock_now_us;
+}
+
+uint32_t mock_hx711_gain(void) {
+    return mock_hx711_gain_applied;
+}
+
+// ---------------------------------------------------------------------------
+// Tempo
+// ---------------------------------------------------------------------------
+
+uint32_t time_us_32(void) { return (uint32_t)mock_now_us; }
+uint64_t time_us_64(void) { return mock_now_us; }
+void sleep_us(uint64_t us) { mock_now_us += us; }
+void sleep_ms(uint32_t ms) { mock_now_us += (uint64_t)ms * 1000; }
+void busy_wait_us_32(uint32_t us) { mock_now_us += us; }
+
+absolute_time_t get_absolute_time(void) { return mock_now_us; }
+absolute_time_t make_timeout_time_ms(uint32_t ms) { return mock_now_us + (uint64_t)ms * 1000; }
+absolute_time_t make_timeout_time_us(uint64_t us) { return mock_now_us + us; }
+absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms) { return t + (uint64_t)ms * 1000; }
+absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us) { return t + us; }
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to) { return (int64_t)(to - from); }
+
+bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp) {
+    if (timeout_timestamp > mock_now_us && timeout_timestamp != at_the_end_of_time) {
+        mock_now_us = timeout_timestamp;
+    }
+    return true;
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    (void)us; (void)callback; (void)user_data; (void)fire_if_past;
+    return -1;
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    (void)ms; (void)callback; (void)user_data; (void)fire_if_past;
+    return -1;
+}
+
+bool cancel_alarm(alarm_id_t id) {
+    (void)id;
+    return false;
+}
+
+bool stdio_init_all(void) { return true; }
+int getchar_timeout_us(uint32_t timeout_us) { (void)timeout_us; return PICO_ERROR_TIMEOUT; }
+
+// ---------------------------------------------------------------------------
+// GPIO
+// ---------------------------------------------------------------------------
+
+void gpio_init(uint gpio) {
+    mock_gpios[gpio].output = false;
+    mock_gpios[gpio].value = false;
+    mock_gpios[gpio].playing = false;
+}
+
+void gpio_set_pulls(uint gpio, bool up, bool down) { (void)gpio; (void)up; (void)down; }
+void gpio_pull_up(uint gpio) { (void)gpio; }
+void gpio_disable_pulls(uint gpio) { (void)gpio; }
+void gpio_set_input_enabled(uint gpio, bool enabled) { (void)gpio; (void)enabled; }
+void gpio_put(uint gpio, bool value) { mock_gpios[gpio].value = value; }
+
+// Liberar a linha (saída -> entrada) inicia a resposta do sensor
+void gpio_set_dir(uint gpio, bool out) {
+    mock_gpio_t *g = &mock_gpios[gpio];
+    if (g->output && !out && g->wave != NULL && g->wave->count > 0) {
+        g->playing = true;
+        g->release_us = mock_now_us;
+        g->segment = 0;
+        g->segment_end_us = mock_now_us + g->wave->segments[0].duration_us;
+    }
+    g->output = out;
+}
+
+bool gpio_get(uint gpio) {
+    mock_gpio_t *g = &mock_gpios[gpio];
+    mock_now_us += MOCK_POLL_COST_US;
+
+    if (g->output) {
+        return g->value;
+    }
+    if (!g->playing) {
+        return true; // Pull-up
+    }
+
+    while (mock_now_us >= g->segment_end_us) {
+        if (++g->segment >= g->wave->count) {
+            g->playing = false;
+            return true;
+        }
+        g->segment_end_us += g->wave->segments[g->segment].duration_us;
+    }
+    return g->wave->segments[g->segment].level;
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled) {
+    if (enabled) {
+        mock_gpios[gpio].irq_enabled |= event_mask;
+    } else {
+        mock_gpios[gpio].irq_enabled &= ~event_mask;
+    }
+}
+void gpio_add_raw_irq_handler(uint gpio, irq_handler_t handler) { mock_gpios[gpio].irq_handler = handler; }
+uint32_t gpio_get_irq_event_mask(uint gpio) { return mock_gpios[gpio].irq_pending; }
+void gpio_acknowledge_irq(uint gpio, uint32_t event_mask) { mock_gpios[gpio].irq_pending &= ~event_mask; }
+
+// ---------------------------------------------------------------------------
+// PIO
+// ---------------------------------------------------------------------------
+
+bool pio_can_add_program(PIO pio, const pio_program_t *program) { (void)pio; (void)program; return true; }
+uint pio_add_program(PIO pio, const pio_program_t *program) { (void)pio; (void)program; return 0; }
+
+int pio_claim_unused_sm(PIO pio, bool required) {
+    (void)required;
+    int block = pio == pio0 ? 0 : 1;
+    for (int sm = 0; sm < MOCK_NUM_SMS; sm++) {
+        if (!mock_sm_claimed[block][sm]) {
+            mock_sm_claimed[block][sm] = true;
+            return sm;
+        }
+    }
+    return -1;
+}
+
+void pio_sm_unclaim(PIO pio, uint sm) { mock_sm_claimed[pio == pio0 ? 0 : 1][sm] = false; }
+void pio_gpio_init(PIO pio, uint pin) { (void)pio; (void)pin; }
+
+void pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pin_base, uint pin_count, bool is_out) {
+    (void)pio; (void)sm; (void)pin_count; (void)is_out;
+    mock_last_pindirs_pin = pin_base;
+}
+
+void pio_sm_set_enabled(PIO pio, uint sm, bool enabled) { (void)pio; (void)sm; (void)enabled; }
+void pio_sm_clear_fifos(PIO pio, uint sm) {
+    mock_rx_level = 0;
+    mock_tx_level[pio == pio0 ? 0 : 1][sm] = 0;
+}
+void pio_sm_set_pins_with_mask(PIO pio, uint sm, uint32_t pin_values, uint32_t pin_mask) {
+    (void)pio; (void)sm; (void)pin_values; (void)pin_mask;
+}
+void pio_sm_restart(PIO pio, uint sm) { (void)pio; (void)sm; }
+void pio_sm_exec(PIO pio, uint sm, uint instr) { (void)pio; (void)sm; (void)instr; }
+void pio_sm_put(PIO pio, uint sm, uint32_t data) {
+    uint32_t *level = &mock_tx_level[pio == pio0 ? 0 : 1][sm];
+    if (*level < 4) {
+        (*level)++;
+        mock_tx_last[pio == pio0 ? 0 : 1][sm] = data;
+    }
+}
+bool pio_sm_is_tx_fifo_full(PIO pio, uint sm) { return mock_tx_level[pio == pio0 ? 0 : 1][sm] >= 4; }
+void pio_sm_put_blocking(PIO pio, uint sm, uint32_t data) { (void)pio; (void)sm; (void)data; }
+uint pio_get_dreq(PIO pio, uint sm, bool is_tx) { (void)pio; (void)sm; (void)is_tx; return 0; }
+uint pio_get_irq_num(PIO pio, uint irqn) { (void)pio; return irqn; }
+void pio_set_irqn_source_enabled(PIO pio, uint irq_index, pio_interrupt_source_t source, bool enabled) {
+    (void)pio; (void)irq_index; (void)source; (void)enabled;
+}
+
+// Interrupções: a RX FIFO simulada enche na própria consulta, sem precisar do tratador
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority) {
+    (void)num; (void)handler; (void)order_priority;
+}
+void irq_set_enabled(uint num, bool enabled) { (void)num; (void)enabled; }
+
+// RX FIFO do HX711: vazia até a próxima conversão, que chega adiantando o relógio
+bool pio_sm_is_rx_fifo_empty(PIO pio, uint sm) {
+    if (mock_rx_level > 0) {
+        return false;
+    }
+    if (mock_now_us < mock_next_conversion_us) {
+        mock_now_us = mock_next_conversion_us;
+    }
+    mock_next_conversion_us = mock_now_us + MOCK_HX711_PERIOD_US;
+    mock_rx_level = 1;
+    uint32_t *tx_level = &mock_tx_level[pio == pio0 ? 0 : 1][sm];
+    if (*tx_level > 0) {
+        (*tx_level)--; // "pull noblock" do ganho no início da conversão
+        mock_hx711_gain_applied = mock_tx_last[pio == pio0 ? 0 : 1][sm];
+    }
+    return true;
+}
+
+uint pio_sm_get_rx_fifo_level(PIO pio, uint sm) { (void)pio; (void)sm; return mock_rx_level; }
+
+uint32_t pio_sm_get(PIO pio, uint sm) {
+    (void)pio; (void)sm;
+    if (mock_rx_level > 0) {
+        mock_rx_level--;
+    }
+    int32_t value = mock_hx711_source ? mock_hx711_source(mock_hx711_context) : 0;
+    return (uint32_t)value & 0x00FFFFFFu; // 24 bits, como deslocados pelo PIO
+}
+
+// ---------------------------------------------------------------------------
+// DMA
+// ---------------------------------------------------------------------------
+
+int dma_claim_unused_channel(bool required) {
+    (void)required;
+    for (int i = 0; i < MOCK_NUM_DMA_CHANNELS; i++) {
+        if (!mock_dma_claimed[i]) {
+            mock_dma_claimed[i] = true;
+            return i;
+        }
+    }
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel) { mock_dma_claimed[channel] = false; }
+dma_channel_config dma_channel_get_default_config(uint channel) { (void)channel; return (dma_channel_config){0}; }
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) { (void)c; (void)size; }
+void channel_config_set_read_increment(dma_channel_config *c, bool incr) { (void)c; (void)incr; }
+void channel_config_set_write_increment(dma_channel_config *c, bool incr) { (void)c; (void)incr; }
+void channel_config_set_dreq(dma_channel_config *c, uint dreq) { (void)c; (void)dreq; }
+void channel_config_set_ring(dma_channel_config *c, bool write, uint size_bits) { (void)c; (void)write; (void)size_bits; }
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger) {
+    (void)config; (void)write_addr; (void)read_addr; (void)trigger;
+    mock_dma_hw[channel].transfer_count = transfer_count;
+}
+
+// Captura PIO do DHT22: entrega de imediato as larguras que a SM mediria
+void dma_channel_transfer_to_buffer_now(uint channel, volatile void *write_addr, uint32_t transfer_count) {
+    const mock_waveform_t *wave = mock_gpios[mock_last_pindirs_pin].wave;
+    volatile uint32_t *out = write_addr;
+
+    for (uint32_t i = 0; i < transfer_count; i++) {
+        out[i] = wave != NULL && i < count_of(wave->pulse_widths) ? wave->pulse_widths[i] : 0;
+    }
+    mock_dma_hw[channel].transfer_count = 0;
+}
+
+bool dma_channel_is_busy(uint channel) { return mock_dma_hw[channel].transfer_count != 0; }
+void dma_channel_abort(uint channel) { mock_dma_hw[channel].transfer_count = 0; }
+
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger) {
+    (void)trigger;
+    mock_dma_hw[channel].transfer_count = trans_count;
+}
+
+dma_channel_hw_t *dma_channel_hw_addr(uint channel) { return &mock_dma_hw[channel]; }
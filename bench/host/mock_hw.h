@@ -0,0 +1,82 @@
+#ifndef MOCK_HW_H
+#define MOCK_HW_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Número de pinos simulados
+#define MOCK_NUM_GPIOS 30
+
+// Segmentos por forma de onda: resposta (3) + 2 por bit + final
+#define MOCK_MAX_SEGMENTS 96
+
+// Custo simulado de cada gpio_get() (µs): permite que os laços de espera avancem
+#define MOCK_POLL_COST_US 1
+
+// Período de conversão simulado do HX711 (80 SPS)
+#define MOCK_HX711_PERIOD_US 12500
+
+// Trecho em que o sensor mantém a linha em um nível
+typedef struct {
+    bool level;
+    uint32_t duration_us;
+} mock_segment_t;
+
+/**
+ * Resposta de um DHT22, a partir do instante em que o host libera a linha.
+ *
+ * No modo GPIO, gpio_get() devolve o nível do segmento correspondente ao
+ * relógio simulado; no modo PIO, o DMA simulado entrega pulse_widths, as
+ * larguras que a máquina de estados mediria.
+ */
+typedef struct {
+    uint32_t count;                          // Segmentos válidos
+    mock_segment_t segments[MOCK_MAX_SEGMENTS];
+    uint32_t pulse_widths[40];               // Larguras dos pulsos HIGH de dados
+} mock_waveform_t;
+
+// Fonte das conversões do HX711 simulado
+typedef int32_t (*mock_hx711_source_t)(void *context);
+
+/**
+ * Volta o relógio, os pinos e as fontes simuladas ao estado inicial
+ */
+void mock_reset(void);
+
+/**
+ * Associa uma forma de onda a um pino, reproduzida a cada liberação da linha
+ *
+ * @param pin Pino do sensor
+ * @param wave Forma de onda (deve permanecer válida; NULL = linha sempre em HIGH)
+ */
+void mock_set_waveform(uint32_t pin, const mock_waveform_t *wave);
+
+/**
+ * Define a fonte das conversões entregues pela RX FIFO do HX711
+ *
+ * @param source Função chamada a cada conversão (NULL = zero)
+ * @param context Contexto repassado à função
+ */
+void mock_set_hx711_source(mock_hx711_source_t source, void *context);
+
+/**
+ * Simula bordas em um pino: as habilitadas por gpio_set_irq_enabled() ficam
+ * pendentes e o tratador bruto do pino é chamado, como na IO_IRQ_BANK0
+ *
+ * @param pin Pino
+ * @param events Bordas (GPIO_IRQ_EDGE_FALL e/ou GPIO_IRQ_EDGE_RISE)
+ */
+void mock_gpio_edge(uint32_t pin, uint32_t events);
+
+/**
+ * @return Relógio simulado em µs
+ */
+uint64_t mock_time_us(void);
+
+/**
+ * @return Ganho que o HX711 simulado recebeu no último "pull noblock" que
+ *         encontrou a TX FIFO com um valor
+ */
+uint32_t mock_hx711_gain(void);
+
+#endif
@@ -0,0 +1,78 @@
+#include "waveforms.h"
+
+// Temporização do protocolo (datasheet do AM2302)
+#define WAVE_RELEASE_US 10           // Atraso até o sensor puxar a linha, após os 30 µs em HIGH do host
+#define WAVE_PRESENCE_LOW_US 80      // Resposta: LOW
+#define WAVE_PRESENCE_HIGH_US 80     // Resposta: HIGH
+#define WAVE_BIT_LOW_US 50           // LOW que precede cada bit
+#define WAVE_END_LOW_US 50           // LOW final antes de liberar a linha
+
+const waveform_scenario_t waveform_scenarios[] = {
+    {"nominal",        234, 652, 26, 70, 0, false}, // Pulsos do datasheet
+    {"negativo",      -101, 305, 26, 70, 0, false}, // Bit de sinal da temperatura
+    {"jitter",         225, 480, 26, 70, 6, false}, // Atrasos de interrupção na captura
+    {"cabo longo",     301, 702, 48, 95, 3, false}, // Bits 0 esticados até o limite fixo de 50 µs
+    {"pulsos curtos",  150, 900, 18, 45, 2, false}, // Clone rápido: bits 1 abaixo do limite fixo
+    {"dht11",          230, 550, 26, 70, 2, true},  // Quadro do DHT11 com DHT22_PROFILE_DHT11
+};
+
+const uint32_t waveform_scenario_count = sizeof(waveform_scenarios) / sizeof(waveform_scenarios[0]);
+
+// Gerador congruente linear: reprodutível entre execuções
+static uint32_t waveform_random(uint32_t *seed) {
+    *seed = *seed * 1664525u + 1013904223u;
+    return *seed >> 8;
+}
+
+void waveform_frame(const waveform_scenario_t *scenario, uint8_t *frame) {
+    if (scenario->dht11_frame) {
+        frame[0] = (uint8_t)(scenario->humidity_x10 / 10);
+        frame[1] = 0;
+        frame[2] = (uint8_t)(scenario->temperature_x10 / 10);
+        frame[3] = 0;
+        frame[4] = (uint8_t)(frame[0] + frame[2]);
+        return;
+    }
+
+    uint16_t temperature = scenario->temperature_x10 < 0
+                               ? (uint16_t)(0x8000 | -scenario->temperature_x10)
+                               : (uint16_t)scenario->temperature_x10;
+
+    frame[0] = (uint8_t)(scenario->humidity_x10 >> 8);
+    frame[1] = (uint8_t)scenario->humidity_x10;
+    frame[2] = (uint8_t)(temperature >> 8);
+    frame[3] = (uint8_t)temperature;
+    frame[4] = (uint8_t)(frame[0] + frame[1] + frame[2] + frame[3]);
+}
+
+// Acrescenta um segmento à forma de onda
+static void waveform_push(mock_waveform_t *wave, bool level, uint32_t duration_us) {
+    wave->segments[wave->count].level = level;
+    wave->segments[wave->count].duration_us = duration_us;
+    wave->count++;
+}
+
+void waveform_build(const waveform_scenario_t *scenario, uint32_t *seed, mock_waveform_t *wave) {
+    uint8_t frame[5];
+    waveform_frame(scenario, frame);
+
+    wave->count = 0;
+    waveform_push(wave, true, WAVE_RELEASE_US);
+    waveform_push(wave, false, WAVE_PRESENCE_LOW_US);
+    waveform_push(wave, true, WAVE_PRESENCE_HIGH_US);
+
+    for (int i = 0; i < 40; i++) {
+        bool bit = (frame[i / 8] >> (7 - (i % 8))) & 1;
+        uint32_t width = bit ? scenario->one_us : scenario->zero_us;
+
+        if (scenario->jitter_us > 0) {
+            uint32_t span = 2 * scenario->jitter_us + 1;
+            width = width + (waveform_random(seed) % span) - scenario->jitter_us;
+        }
+
+        waveform_push(wave, false, WAVE_BIT_LOW_US);
+        waveform_push(wave, true, width);
+        wave->pulse_widths[i] = width;
+    }
+    waveform_push(wave, false, WAVE_END_LOW_US);
+}
@@ -0,0 +1,40 @@
+#ifndef WAVEFORMS_H
+#define WAVEFORMS_H
+
+#include <stdint.h>
+#include "mock_hw.h"
+
+// Cenário sintético de resposta do DHT22
+typedef struct {
+    const char *name;            // Nome exibido nos resultados
+    int16_t temperature_x10;     // Temperatura codificada no quadro (décimos de °C)
+    uint16_t humidity_x10;       // Umidade codificada no quadro (décimos de %)
+    uint32_t zero_us;            // Largura nominal do HIGH de um bit 0
+    uint32_t one_us;             // Largura nominal do HIGH de um bit 1
+    uint32_t jitter_us;          // Variação máxima (±) aplicada a cada pulso
+    bool dht11_frame;            // Quadro do DHT11: valores inteiros nos bytes 0 e 2
+} waveform_scenario_t;
+
+// Cenários usados pelos benchmarks
+extern const waveform_scenario_t waveform_scenarios[];
+extern const uint32_t waveform_scenario_count;
+
+/**
+ * Monta o quadro de 5 bytes (umidade, temperatura e checksum) de um cenário,
+ * no formato do DHT22 ou do DHT11
+ *
+ * @param scenario Cenário
+ * @param frame Destino dos 5 bytes
+ */
+void waveform_frame(const waveform_scenario_t *scenario, uint8_t *frame);
+
+/**
+ * Gera a forma de onda completa da resposta: presença, 40 bits e final
+ *
+ * @param scenario Cenário
+ * @param seed Semente do gerador da variação (atualizada a cada chamada)
+ * @param wave Destino da forma de onda
+ */
+void waveform_build(const waveform_scenario_t *scenario, uint32_t *seed, mock_waveform_t *wave);
+
+#endif
@@ -0,0 +1,335 @@
+// Microbenchmarks dos caminhos críticos dos drivers, executados no RP2040.
+//
+// Cada caso roda milhares de vezes e é medido pelo SysTick (ciclos) e
+// convertido em µs pelo clock do sistema; os resultados (mínimo, mediana e
+// máximo) saem pela USB. O conjunto é repetido em cada clock de
+// BENCH_CLOCKS_KHZ, e os kernels de conversão são medidos em flash (cache
+// quente e fria) e em RAM (__not_in_flash_func).
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/stdio_usb.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+#include "hardware/structs/xip_ctrl.h"
+#include "hx711.h"
+#include "hx711_multi.h"
+#include "weight_filter.h"
+
+// O decodificador do DHT22 é interno ao driver: o arquivo é incluído para
+// medir as funções estáticas exatamente como compiladas no firmware
+#include "dht22.c"
+
+// Pinos (os mesmos de smart-bag.c); sem HX711 ligado, a leitura é reportada como falha
+#define BENCH_HX711_DT_PIN 2
+#define BENCH_HX711_SCK_PIN 3
+
+// Modo multicanal: DOUT em pinos consecutivos e SCK compartilhado
+#define BENCH_HX711_MULTI_DT_BASE 6
+#define BENCH_HX711_MULTI_CELLS 2
+#define BENCH_HX711_MULTI_SCK_PIN 10
+
+#define BENCH_ITERATIONS 2000          // Execuções por caso
+#define BENCH_HX711_READS 100          // Leituras reais do HX711 (1,25 s a 80 SPS)
+#define BENCH_BATCH_SIZE 64            // Amostras por chamada dos kernels de conversão
+#define BENCH_SYSTICK_MAX 0x00FFFFFFu  // Recarga máxima do SysTick (24 bits)
+#define BENCH_RERUN_COMMAND 'r'        // Caractere que repete o conjunto
+
+// Calibração sintética: tara em 84000 contagens, 1 kg = 420000 contagens
+#define BENCH_TARE_READING 84000
+#define BENCH_CAL_READING (BENCH_TARE_READING + 420000)
+#define BENCH_CAL_WEIGHT 1000.0f
+
+// Clocks do sistema comparados (kHz); 125 MHz é o padrão do SDK
+static const uint32_t BENCH_CLOCKS_KHZ[] = {48000, 125000, 133000};
+
+typedef void (*bench_fn_t)(void *context);
+
+static uint32_t bench_cycles[BENCH_ITERATIONS];
+static uint32_t bench_overhead;
+static volatile int32_t bench_sink;
+
+static int32_t bench_raw[BENCH_BATCH_SIZE];
+static int32_t bench_out[BENCH_BATCH_SIZE];
+static dht22_t bench_dht22;
+
+// Quadro de referência: 65,2 % e 23,4 °C
+static const uint8_t BENCH_DHT22_FRAME[5] = {0x02, 0x8C, 0x00, 0xEA, 0x78};
+
+// SysTick como contador livre no clock do processador
+static void bench_cycles_init(void) {
+    systick_hw->csr = 0;
+    systick_hw->rvr = BENCH_SYSTICK_MAX;
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5; // ENABLE | CLKSOURCE (clock do processador)
+}
+
+static int bench_compare(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Mede uma execução de fn em ciclos (SysTick é decrescente)
+static inline uint32_t bench_measure(bench_fn_t fn, void *context) {
+    uint32_t start = systick_hw->cvr;
+    fn(context);
+    uint32_t end = systick_hw->cvr;
+    return (start - end) & BENCH_SYSTICK_MAX;
+}
+
+static void bench_empty(void *context) {
+    (void)context;
+}
+
+// Executa um caso, opcionalmente esvaziando o cache XIP antes de cada execução
+static void bench_run(const char *name, bench_fn_t fn, void *context, uint32_t iterations, bool cold_cache) {
+    uint32_t hz = clock_get_hz(clk_sys);
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        if (cold_cache) {
+            xip_ctrl_hw->flush = 1;
+            (void)xip_ctrl_hw->flush; // A leitura bloqueia até o fim do flush
+        }
+        uint32_t cycles = bench_measure(fn, context);
+        bench_cycles[i] = cycles > bench_overhead ? cycles - bench_overhead : 0;
+    }
+    qsort(bench_cycles, iterations, sizeof(bench_cycles[0]), bench_compare);
+
+    uint32_t min = bench_cycles[0];
+    uint32_t median = bench_cycles[iterations / 2];
+    uint32_t max = bench_cycles[iterations - 1];
+    printf("%-36s %8lu %8lu %8lu cyc | %9.2f %9.2f %9.2f us\n", name,
+           (unsigned long)min, (unsigned long)median, (unsigned long)max,
+           min * 1e6 / hz, median * 1e6 / hz, max * 1e6 / hz);
+}
+
+// ---------------------------------------------------------------------------
+// DHT22
+// ---------------------------------------------------------------------------
+
+// Preenche as larguras de pulso de um quadro (bit 0 = 26 µs, bit 1 = 70 µs)
+static void bench_dht22_setup(void) {
+    for (int i = 0; i < DHT22_NUM_BITS; i++) {
+        bool bit = (BENCH_DHT22_FRAME[i / 8] >> (7 - (i % 8))) & 1;
+        bench_dht22.pulse_widths[i] = bit ? 70 : 26;
+    }
+}
+
+// Decodificação completa: limite adaptativo, checksum e conversão
+static void bench_dht22_decode(void *context) {
+    (void)context;
+    uint8_t data[5] = {0};
+    int16_t temperature_x10;
+    uint16_t humidity_x10;
+    float temperature, humidity;
+
+    dht22_decode_pulses(&bench_dht22, data);
+    if (dht22_verify_checksum(data) == DHT22_OK) {
+        dht22_convert_data(data, false, &temperature_x10, &humidity_x10, &temperature, &humidity);
+    }
+    bench_sink = data[4];
+}
+
+// ---------------------------------------------------------------------------
+// HX711
+// ---------------------------------------------------------------------------
+
+static void bench_hx711_read(void *context) {
+    (void)context;
+    bench_sink = hx711_read(BENCH_HX711_DT_PIN, BENCH_HX711_SCK_PIN);
+}
+
+static void bench_hx711_multi_read(void *context) {
+    (void)context;
+    int32_t weight_mg = 0;
+    hx711_multi_read_mg(&weight_mg);
+    bench_sink = weight_mg;
+}
+
+// Inicializa o modo multicanal com a calibração sintética em todas as células
+static bool bench_hx711_multi_setup(void) {
+    int32_t raw[HX711_MULTI_MAX_CHANNELS];
+    hx711_coeffs_t coeffs;
+
+    if (hx711_multi_init(BENCH_HX711_MULTI_DT_BASE, BENCH_HX711_MULTI_CELLS, BENCH_HX711_MULTI_SCK_PIN) !=
+        HX711_MULTI_OK) {
+        return false;
+    }
+    hx711_compute_coeffs(&coeffs, BENCH_TARE_READING, scale_factor);
+    for (uint32_t c = 0; c < BENCH_HX711_MULTI_CELLS; c++) {
+        hx711_multi_set_coeffs(c, &coeffs);
+    }
+    return hx711_multi_read(raw) == HX711_MULTI_OK;
+}
+
+static void bench_calculate_weight(void *context) {
+    (void)context;
+    float sum = 0.0f;
+    for (int i = 0; i < BENCH_BATCH_SIZE; i++) {
+        sum += calculate_weight(bench_raw[i]);
+    }
+    bench_sink = (int32_t)sum;
+}
+
+static void bench_calculate_weight_mg(void *context) {
+    (void)context;
+    int32_t sum = 0;
+    for (int i = 0; i < BENCH_BATCH_SIZE; i++) {
+        sum += calculate_weight_mg(bench_raw[i]);
+    }
+    bench_sink = sum;
+}
+
+static void bench_convert_batch(void *context) {
+    (void)context;
+    hx711_convert_batch(bench_raw, bench_out, BENCH_BATCH_SIZE);
+}
+
+// Kernels idênticos compilados em flash e em RAM, para comparar o posicionamento
+#define BENCH_FLOAT_KERNEL                                               \
+    float sum = 0.0f;                                                    \
+    for (int i = 0; i < BENCH_BATCH_SIZE; i++) {                         \
+        sum += (float)(bench_raw[i] - tare_offset) * scale_factor;      \
+    }                                                                    \
+    bench_sink = (int32_t)sum;
+
+#define BENCH_FIXED_KERNEL                                               \
+    hx711_coeffs_t coeffs = hx711_coeffs;                                \
+    for (int i = 0; i < BENCH_BATCH_SIZE; i++) {                         \
+        bench_out[i] = hx711_apply_coeffs(&coeffs, bench_raw[i]);        \
+    }
+
+static void __attribute__((noinline)) bench_float_flash(void *context) {
+    (void)context;
+    BENCH_FLOAT_KERNEL
+}
+
+static void __not_in_flash_func(bench_float_ram)(void *context) {
+    (void)context;
+    BENCH_FLOAT_KERNEL
+}
+
+static void __attribute__((noinline)) bench_fixed_flash(void *context) {
+    (void)context;
+    BENCH_FIXED_KERNEL
+}
+
+static void __not_in_flash_func(bench_fixed_ram)(void *context) {
+    (void)context;
+    BENCH_FIXED_KERNEL
+}
+
+// ---------------------------------------------------------------------------
+// Filtros
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    weight_filter_t filter;
+    uint32_t index;
+} bench_filter_t;
+
+static void bench_filter_update(void *context) {
+    bench_filter_t *b = context;
+    bench_sink = weight_filter_update(&b->filter, bench_raw[b->index++ % BENCH_BATCH_SIZE]);
+}
+
+static void bench_filter_case(const char *name, weight_filter_type_t type, uint32_t param) {
+    static bench_filter_t b;
+    weight_filter_init(&b.filter, type, param);
+    b.index = 0;
+    bench_run(name, bench_filter_update, &b, BENCH_ITERATIONS, false);
+}
+
+static void bench_settle_update(void *context) {
+    weight_settle_t *settle = context;
+    static uint32_t index;
+    bench_sink = weight_settle_update(settle, bench_raw[index++ % BENCH_BATCH_SIZE]);
+}
+
+// ---------------------------------------------------------------------------
+// Conjunto
+// ---------------------------------------------------------------------------
+
+static void bench_suite(void) {
+    weight_settle_t settle;
+
+    bench_overhead = 0;
+    for (int i = 0; i < 16; i++) {
+        uint32_t cycles = bench_measure(bench_empty, NULL);
+        if (i == 0 || cycles < bench_overhead) bench_overhead = cycles;
+    }
+
+    printf("\n== clk_sys %lu kHz (%lu execucoes, %u amostras por lote) ==\n",
+           (unsigned long)(clock_get_hz(clk_sys) / 1000), (unsigned long)BENCH_ITERATIONS, BENCH_BATCH_SIZE);
+    printf("%-36s %8s %8s %8s     | %9s %9s %9s\n", "caso", "min", "mediana", "max", "min", "mediana", "max");
+
+    bench_run("dht22 decodificacao (40 bits)", bench_dht22_decode, NULL, BENCH_ITERATIONS, false);
+
+    bench_run("calculate_weight (float, lote)", bench_calculate_weight, NULL, BENCH_ITERATIONS, false);
+    bench_run("calculate_weight_mg (Q16.16, lote)", bench_calculate_weight_mg, NULL, BENCH_ITERATIONS, false);
+    bench_run("hx711_convert_batch (lote)", bench_convert_batch, NULL, BENCH_ITERATIONS, false);
+
+    bench_run("float flash, cache quente", bench_float_flash, NULL, BENCH_ITERATIONS, false);
+    bench_run("float flash, cache fria", bench_float_flash, NULL, BENCH_ITERATIONS, true);
+    bench_run("float RAM", bench_float_ram, NULL, BENCH_ITERATIONS, false);
+    bench_run("ponto fixo flash, cache quente", bench_fixed_flash, NULL, BENCH_ITERATIONS, false);
+    bench_run("ponto fixo flash, cache fria", bench_fixed_flash, NULL, BENCH_ITERATIONS, true);
+    bench_run("ponto fixo RAM", bench_fixed_ram, NULL, BENCH_ITERATIONS, false);
+
+    bench_filter_case("media movel (16)", WEIGHT_FILTER_MOVING_AVERAGE, 16);
+    bench_filter_case("mediana (5)", WEIGHT_FILTER_MEDIAN, 5);
+    bench_filter_case("mediana (31)", WEIGHT_FILTER_MEDIAN, 31);
+    bench_filter_case("iir (shift 4)", WEIGHT_FILTER_IIR, 4);
+    weight_settle_init(&settle, 200, 8);
+    bench_run("weight_settle_update", bench_settle_update, &settle, BENCH_ITERATIONS, false);
+
+    // Inclui a espera pela conversão: o mínimo aproxima o custo com a FIFO já preenchida
+    if (hx711_init(BENCH_HX711_DT_PIN, BENCH_HX711_SCK_PIN) == HX711_OK &&
+        hx711_read(BENCH_HX711_DT_PIN, BENCH_HX711_SCK_PIN) != HX711_READ_ERROR) {
+        bench_run("hx711_read (24 bits, com espera)", bench_hx711_read, NULL, BENCH_HX711_READS, false);
+    } else {
+        printf("%-36s sem HX711 nos pinos %d/%d\n", "hx711_read", BENCH_HX711_DT_PIN, BENCH_HX711_SCK_PIN);
+    }
+
+    // Todas as células na mesma janela de conversão: o custo não cresce com o número de células
+    if (bench_hx711_multi_setup()) {
+        bench_run("hx711_multi_read_mg (2 celulas)", bench_hx711_multi_read, NULL, BENCH_HX711_READS, false);
+    } else {
+        printf("%-36s sem HX711 nos pinos %d..%d/%d\n", "hx711_multi_read", BENCH_HX711_MULTI_DT_BASE,
+               BENCH_HX711_MULTI_DT_BASE + BENCH_HX711_MULTI_CELLS - 1, BENCH_HX711_MULTI_SCK_PIN);
+    }
+}
+
+int main() {
+    stdio_init_all();
+    while (!stdio_usb_connected()) {
+        sleep_ms(100);
+    }
+
+    bench_cycles_init();
+    bench_dht22_setup();
+    tare_hx711(BENCH_TARE_READING);
+    calibrate_hx711(BENCH_CAL_READING, BENCH_CAL_WEIGHT);
+    for (int i = 0; i < BENCH_BATCH_SIZE; i++) {
+        bench_raw[i] = BENCH_CAL_READING + (i * 37) % 1024 - 512;
+    }
+
+    while (true) {
+        for (size_t i = 0; i < count_of(BENCH_CLOCKS_KHZ); i++) {
+            if (!set_sys_clock_khz(BENCH_CLOCKS_KHZ[i], false)) {
+                printf("\nclk_sys %lu kHz indisponivel\n", (unsigned long)BENCH_CLOCKS_KHZ[i]);
+                continue;
+            }
+            sleep_ms(10);
+            bench_suite();
+        }
+        set_sys_clock_khz(125000, true);
+
+        printf("\nEnvie '%c' para repetir\n", BENCH_RERUN_COMMAND);
+        while (getchar_timeout_us(1000000) != BENCH_RERUN_COMMAND) {
+        }
+    }
+}
@@ -0,0 +1,97 @@
+#include "calibration.h"
+#include "crc32.h"
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include <stddef.h>
+#include <string.h>
+
+// Último setor da flash, reservado para configuração (o log fica logo antes)
+#define CALIBRATION_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+
+#define CALIBRATION_MAGIC 0x424C4143u     // "CALB"
+#define CALIBRATION_VERSION 1
+#define CALIBRATION_SAFE_TIMEOUT_MS 100   // Espera máxima para pausar o outro núcleo
+
+// Formato gravado na flash
+typedef struct {
+    uint32_t magic;              // CALIBRATION_MAGIC
+    uint32_t version;            // CALIBRATION_VERSION
+    calibration_t calibration;   // Conteúdo
+    uint32_t crc;                // CRC-32 dos campos anteriores
+} calibration_record_t;
+
+_Static_assert(sizeof(calibration_record_t) <= FLASH_PAGE_SIZE, "registro de calibração deve caber em uma página");
+
+static inline const calibration_record_t *calibration_stored(void) {
+    return (const calibration_record_t *)(uintptr_t)(XIP_BASE + CALIBRATION_OFFSET);
+}
+
+static uint32_t calibration_crc(const calibration_record_t *record) {
+    return crc32_update(CRC32_INIT, record, offsetof(calibration_record_t, crc));
+}
+
+// Executada com o outro núcleo pausado e as interrupções desabilitadas
+static void calibration_do_program(void *param) {
+    flash_range_erase(CALIBRATION_OFFSET, FLASH_SECTOR_SIZE);
+    flash_range_program(CALIBRATION_OFFSET, param, FLASH_PAGE_SIZE);
+}
+
+// Lê o registro de calibração da flash
+int calibration_load(calibration_t *calibration) {
+    calibration_record_t record;
+    memcpy(&record, calibration_stored(), sizeof(record));
+
+    if (record.magic != CALIBRATION_MAGIC) {
+        return CALIBRATION_ERROR_EMPTY; // Setor apagado ou nunca usado para calibração
+    }
+    if (record.version != CALIBRATION_VERSION || record.crc != calibration_crc(&record) ||
+        record.calibration.channels == 0 || record.calibration.channels > HX711_MULTI_MAX_CHANNELS) {
+        return CALIBRATION_ERROR_CORRUPT;
+    }
+
+    *calibration = record.calibration;
+    return CALIBRATION_OK;
+}
+
+// Grava o registro, apagando o setor só quando o conteúdo mudou
+int calibration_save(const calibration_t *calibration) {
+    uint8_t page[FLASH_PAGE_SIZE] __attribute__((aligned(8)));
+    calibration_record_t *record = (calibration_record_t *)page;
+
+    if (calibration->channels == 0 || calibration->channels > HX711_MULTI_MAX_CHANNELS) {
+        return CALIBRATION_ERROR_INVALID;
+    }
+
+    memset(page, 0xFF, sizeof(page));
+    memset(record, 0, sizeof(*record)); // Bytes de preenchimento entram no CRC
+    record->magic = CALIBRATION_MAGIC;
+    record->version = CALIBRATION_VERSION;
+    memcpy(&record->calibration, calibration, sizeof(*calibration));
+    record->crc = calibration_crc(record);
+
+    if (memcmp(record, calibration_stored(), sizeof(*record)) == 0) {
+        return CALIBRATION_OK;
+    }
+    if (flash_safe_execute(calibration_do_program, page, CALIBRATION_SAFE_TIMEOUT_MS) != PICO_OK) {
+        return CALIBRATION_ERROR_FLASH;
+    }
+    return CALIBRATION_OK;
+}
+
+// Preenche a célula 0 com a calibração atual do driver de um canal
+void calibration_capture(calibration_t *calibration) {
+    calibration->cells[0].scale = scale_factor;
+    calibration->cells[0].tare = tare_offset;
+    calibration->cells[0].coeffs = hx711_coeffs;
+    if (calibration->channels == 0) {
+        calibration->channels = 1;
+    }
+}
+
+// Aplica a calibração ao driver HX711 de um canal
+void calibration_apply(const calibration_t *calibration) {
+    scale_factor = calibration->cells[0].scale;
+    tare_offset = calibration->cells[0].tare;
+    hx711_coeffs = calibration->cells[0].coeffs;
+}
@@ -0,0 +1,69 @@
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include <stdint.h>
+#include "hx711.h"
+#include "hx711_multi.h"
+
+// Códigos de retorno das operações de calibração
+#define CALIBRATION_OK 0                  // Operação bem-sucedida
+#define CALIBRATION_ERROR_EMPTY -1        // Nenhum registro gravado
+#define CALIBRATION_ERROR_CORRUPT -2      // Registro com versão ou CRC inválidos
+#define CALIBRATION_ERROR_FLASH -3        // flash_safe_execute() não conseguiu pausar o outro núcleo
+#define CALIBRATION_ERROR_INVALID -4      // Número de células fora de 1..HX711_MULTI_MAX_CHANNELS
+
+// Calibração de uma célula de carga
+typedef struct {
+    float scale;                 // Unidades calibradas por contagem
+    int32_t tare;                // Leitura bruta sem carga
+    hx711_coeffs_t coeffs;       // Coeficientes em ponto fixo já calculados
+} calibration_cell_t;
+
+/**
+ * Calibração persistida no último setor da flash.
+ *
+ * A célula 0 corresponde ao driver de um canal (scale_factor, tare_offset e
+ * hx711_coeffs); as células 0..channels-1 são reservadas ao modo
+ * multicanal, aplicadas com hx711_multi_set_coeffs() depois de
+ * hx711_multi_init(). Os coeficientes em ponto fixo são gravados prontos, de modo
+ * que a primeira conversão após a partida já produz um peso válido.
+ */
+typedef struct {
+    uint32_t channels;           // Células válidas em cells[]
+    calibration_cell_t cells[HX711_MULTI_MAX_CHANNELS];
+} calibration_t;
+
+/**
+ * Lê o registro de calibração da flash
+ *
+ * @param calibration Destino
+ * @return CALIBRATION_OK, CALIBRATION_ERROR_EMPTY ou CALIBRATION_ERROR_CORRUPT
+ */
+int calibration_load(calibration_t *calibration);
+
+/**
+ * Grava o registro de calibração no último setor da flash
+ *
+ * O setor só é apagado e reprogramado se o conteúdo mudou. Deve ser chamada
+ * com o outro núcleo executando flash_safe_execute_core_init().
+ *
+ * @param calibration Calibração a gravar
+ * @return CALIBRATION_OK, CALIBRATION_ERROR_INVALID ou CALIBRATION_ERROR_FLASH
+ */
+int calibration_save(const calibration_t *calibration);
+
+/**
+ * Preenche a célula 0 com a calibração atual do driver de um canal
+ *
+ * @param calibration Destino (channels passa a valer ao menos 1)
+ */
+void calibration_capture(calibration_t *calibration);
+
+/**
+ * Aplica a célula 0 ao driver HX711 de um canal
+ *
+ * @param calibration Calibração carregada com calibration_load()
+ */
+void calibration_apply(const calibration_t *calibration);
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Valor inicial para crc32_update() (CRC-32 IEEE 802.3, o mesmo do zlib)
+#define CRC32_INIT 0
+
+/**
+ * Atualiza um CRC-32 com mais dados
+ *
+ * Permite calcular o CRC de blocos não contíguos: passe CRC32_INIT na
+ * primeira chamada e o resultado anterior nas seguintes.
+ *
+ * @param crc CRC acumulado
+ * @param data Dados
+ * @param length Tamanho em bytes
+ * @return CRC atualizado
+ */
+uint32_t crc32_update(uint32_t crc, const void *data, size_t length);
+
+#endif
@@ -1,25 +1,36 @@
 #include "dht22.h"
 #include "pico/stdlib.h"
 #include "hardware/gpio.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/sync.h"
+#include "dht22.pio.h"
+#include "metrics.h"
+#include "trace.h"
+#include "ram_func.h"
+#include <string.h>
 
 // Constantes de temporização para o protocolo do DHT22
-#define DHT22_START_SIGNAL_DELAY 18000 // 18ms em microssegundos
-#define DHT22_RESPONSE_WAIT_TIMEOUT 200 // Timeout para resposta em microssegundos
-#define DHT22_BIT_THRESHOLD 50         // Limite para distinguir entre bit 0 e bit 1 (em μs)
-#define DHT22_MIN_INTERVAL_MS 2000     // Intervalo mínimo entre leituras (2 segundos)
+#define DHT22_RESPONSE_WAIT_TIMEOUT 200 // Timeout por pulso de dados em microssegundos
+#define DHT22_BIT_THRESHOLD 50         // Limite padrão entre bit 0 e bit 1 (em μs)
+#define DHT22_MIN_CLUSTER_GAP_US 20    // Separação mínima entre os grupos para o limite adaptativo
+#define DHT22_FRAME_TIMEOUT_US 8000    // Tempo máximo de resposta + 40 bits no modo PIO
+#define DHT22_FRAME_POLL_US 5000       // Duração típica de resposta + 40 bits
+#define DHT22_FRAME_RECHECK_US 500     // Intervalo entre verificações do fim do quadro
+#define DHT22_MAX_BACKOFF_MS 16000     // Maior intervalo entre tentativas após falhas seguidas
 
-// Estado do driver DHT22
-typedef struct {
-    uint32_t last_read_time_ms;  // Timestamp da última leitura
-    uint32_t pin;                // Pino GPIO usado para comunicação
-    bool initialized;            // Indicador de inicialização
-} dht22_state_t;
+// Perfis de temporização, indexados por dht22_profile_t
+static const dht22_timing_t dht22_profiles[] = {
+    [DHT22_PROFILE_DHT11]        = {18000, 200, 1000, true}, // Datasheet do DHT11: LOW >= 18ms
+    [DHT22_PROFILE_DHT22]        = {1100, 200, DHT22_MIN_INTERVAL_MS, false}, // AM2302: LOW >= 1ms
+    [DHT22_PROFILE_CONSERVATIVE] = {18000, 300, 2500, false}, // Clones e cabos longos
+};
 
-// Estado global do driver
-static dht22_state_t dht22_state = {0, 0, false};
+// Offset do programa carregado em cada bloco PIO (-1 = não carregado)
+static int dht22_program_offset[2] = {-1, -1};
 
 // Função auxiliar para esperar até o pino mudar de estado
-static inline int wait_for_pin_state(uint32_t pin, bool state, uint32_t timeout_us) {
+static inline int RAM_FUNC(wait_for_pin_state)(uint32_t pin, bool state, uint32_t timeout_us) {
     uint32_t start = time_us_32();
     while (gpio_get(pin) != state) {
         if ((time_us_32() - start) > timeout_us) {
@@ -29,66 +40,282 @@ static inline int wait_for_pin_state(uint32_t pin, bool state, uint32_t timeout_
     return 0; // Sucesso
 }
 
+// Reserva uma máquina de estados e carrega o programa de captura (uma vez por bloco PIO)
+static int dht22_claim_pio(PIO *pio, uint *sm, uint *offset) {
+    PIO blocks[2] = {pio0, pio1};
+
+    for (int i = 0; i < 2; i++) {
+        if (dht22_program_offset[i] < 0 && !pio_can_add_program(blocks[i], &dht22_program)) {
+            continue;
+        }
+        int claimed = pio_claim_unused_sm(blocks[i], false);
+        if (claimed < 0) {
+            continue;
+        }
+        if (dht22_program_offset[i] < 0) {
+            dht22_program_offset[i] = (int)pio_add_program(blocks[i], &dht22_program);
+        }
+        *pio = blocks[i];
+        *sm = (uint)claimed;
+        *offset = (uint)dht22_program_offset[i];
+        return DHT22_OK;
+    }
+    return DHT22_ERROR_NO_RESOURCES;
+}
+
+// Configura a máquina de estados PIO e o canal DMA para a captura em hardware
+static int dht22_init_pio(dht22_t *dev, uint32_t pin) {
+    int result = dht22_claim_pio(&dev->pio, &dev->sm, &dev->offset);
+    if (result != DHT22_OK) return result;
+
+    dev->dma_chan = dma_claim_unused_channel(false);
+    if (dev->dma_chan < 0) {
+        pio_sm_unclaim(dev->pio, dev->sm);
+        return DHT22_ERROR_NO_RESOURCES;
+    }
+
+    dht22_program_init(dev->pio, dev->sm, dev->offset, pin);
+
+    // DMA: RX FIFO da SM -> pulse_widths[], uma palavra por bit
+    dma_channel_config c = dma_channel_get_default_config(dev->dma_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, pio_get_dreq(dev->pio, dev->sm, false));
+    dma_channel_configure(dev->dma_chan, &c, dev->pulse_widths,
+                          &dev->pio->rxf[dev->sm], DHT22_NUM_BITS, false);
+
+    return DHT22_OK;
+}
+
 // Inicializa o driver DHT22
-int dht22_init(uint32_t pin) {
-    // Configura o pino GPIO
-    gpio_init(pin);
-    gpio_set_pulls(pin, true, false); // Habilita pull-up
+int dht22_init(dht22_t *dev, uint32_t pin, dht22_capture_t capture) {
+    memset(dev, 0, sizeof(*dev));
+    dev->capture = capture;
+    dev->dma_chan = -1;
+    dev->timing = dht22_profiles[DHT22_PROFILE_DHT22];
+    dev->interval_ms = dev->timing.min_interval_ms;
+    dev->max_retries = DHT22_DEFAULT_MAX_RETRIES;
+
+    if (capture == DHT22_CAPTURE_PIO) {
+        int result = dht22_init_pio(dev, pin);
+        if (result != DHT22_OK) return result;
+    } else {
+        // Configura o pino GPIO
+        gpio_init(pin);
+        gpio_set_pulls(pin, true, false); // Habilita pull-up
+    }
     
     // Inicializa o estado do driver
-    dht22_state.pin = pin;
-    dht22_state.last_read_time_ms = 0;
-    dht22_state.initialized = true;
+    dev->pin = pin;
+    dev->initialized = true;
     
     return DHT22_OK;
 }
 
-// Envia o sinal de inicialização para o sensor
-static int dht22_send_start_signal(uint32_t pin) {
+// Inicia o sinal de início: força a linha em LOW
+static inline void dht22_start_signal_low(uint32_t pin) {
     // Configura o pino como saída
     gpio_set_dir(pin, GPIO_OUT);
-    
-    // Envia o sinal de início (LOW por 18ms, depois HIGH por 30us)
     gpio_put(pin, 0);
-    sleep_us(DHT22_START_SIGNAL_DELAY);
+}
+
+// Encerra o sinal de início: HIGH por 30us e libera a linha para a resposta
+static inline void dht22_start_signal_release(uint32_t pin) {
     gpio_put(pin, 1);
-    sleep_us(30);
+    busy_wait_us_32(30);
     
     // Configura o pino como entrada para receber a resposta
     gpio_set_dir(pin, GPIO_IN);
+}
+
+// Envia o sinal de inicialização para o sensor
+static int dht22_send_start_signal(uint32_t pin, uint32_t start_low_us) {
+    // Envia o sinal de início (LOW conforme o perfil, depois HIGH por 30us)
+    TRACE(TRACE_DHT22_START_LOW, start_low_us);
+    dht22_start_signal_low(pin);
+    sleep_us(start_low_us);
+    dht22_start_signal_release(pin);
+    TRACE(TRACE_DHT22_START_RELEASE, 0);
     
     return DHT22_OK;
 }
 
 // Aguarda e verifica a resposta inicial do sensor
-static int dht22_wait_for_response(uint32_t pin) {
+static int RAM_FUNC(dht22_wait_for_response)(uint32_t pin, uint32_t timeout_us) {
+    int result = DHT22_OK;
+    
     // Aguarda a sequência de resposta do sensor
-    if (wait_for_pin_state(pin, 0, DHT22_RESPONSE_WAIT_TIMEOUT) != 0) return DHT22_ERROR_TIMEOUT;
-    if (wait_for_pin_state(pin, 1, DHT22_RESPONSE_WAIT_TIMEOUT) != 0) return DHT22_ERROR_TIMEOUT;
-    if (wait_for_pin_state(pin, 0, DHT22_RESPONSE_WAIT_TIMEOUT) != 0) return DHT22_ERROR_TIMEOUT;
+    if (wait_for_pin_state(pin, 0, timeout_us) != 0 ||
+        wait_for_pin_state(pin, 1, timeout_us) != 0 ||
+        wait_for_pin_state(pin, 0, timeout_us) != 0) {
+        result = DHT22_ERROR_TIMEOUT;
+    }
     
-    return DHT22_OK;
+    TRACE(TRACE_DHT22_RESPONSE, result);
+    return result;
 }
 
-// Lê os 40 bits de dados do sensor
-static int dht22_read_data(uint32_t pin, uint8_t *data) {
-    // Lê os 40 bits (5 bytes) de dados
-    for (int i = 0; i < 40; i++) {
+// Mede a largura dos 40 pulsos HIGH de dados do sensor
+static int RAM_FUNC(dht22_read_data)(uint32_t pin, uint32_t *widths) {
+    for (int i = 0; i < DHT22_NUM_BITS; i++) {
         // Aguarda o início do pulso (LOW para HIGH)
-        if (wait_for_pin_state(pin, 1, DHT22_RESPONSE_WAIT_TIMEOUT) != 0) return DHT22_ERROR_TIMEOUT;
+        if (wait_for_pin_state(pin, 1, DHT22_RESPONSE_WAIT_TIMEOUT) != 0) {
+            TRACE(TRACE_DHT22_DATA, DHT22_ERROR_TIMEOUT);
+            return DHT22_ERROR_TIMEOUT;
+        }
         
         // Mede a duração do pulso HIGH
         uint32_t pulse_start = time_us_32();
-        if (wait_for_pin_state(pin, 0, DHT22_RESPONSE_WAIT_TIMEOUT) != 0) return DHT22_ERROR_TIMEOUT;
-        uint32_t pulse_length = time_us_32() - pulse_start;
-        
-        // Determina o valor do bit com base na duração do pulso
-        if (pulse_length > DHT22_BIT_THRESHOLD) {
+        if (wait_for_pin_state(pin, 0, DHT22_RESPONSE_WAIT_TIMEOUT) != 0) {
+            TRACE(TRACE_DHT22_DATA, DHT22_ERROR_TIMEOUT);
+            return DHT22_ERROR_TIMEOUT;
+        }
+        widths[i] = time_us_32() - pulse_start;
+    }
+    
+    TRACE(TRACE_DHT22_DATA, DHT22_OK);
+    return DHT22_OK;
+}
+
+// Escolhe o limite entre bit 0 (~27 µs) e bit 1 (~70 µs) a partir do próprio
+// quadro: agrupa as larguras em dois grupos (k-médias em 1D, partindo do ponto
+// médio entre a menor e a maior) e usa o ponto médio entre as médias. Se os
+// grupos não estiverem separados (quadro só com zeros ou só com uns), usa o
+// limite fixo.
+static void dht22_calibrate_threshold(const uint32_t *widths, dht22_signal_t *signal) {
+    uint32_t min_width = widths[0];
+    uint32_t max_width = widths[0];
+    for (int i = 1; i < DHT22_NUM_BITS; i++) {
+        if (widths[i] < min_width) min_width = widths[i];
+        if (widths[i] > max_width) max_width = widths[i];
+    }
+    
+    uint32_t threshold = (min_width + max_width) / 2;
+    uint32_t low_mean = 0;
+    uint32_t high_mean = 0;
+    
+    // Duas iterações bastam: os grupos do DHT22 são bem definidos
+    for (int iteration = 0; iteration < 2; iteration++) {
+        uint32_t low_sum = 0, low_count = 0;
+        uint32_t high_sum = 0, high_count = 0;
+        for (int i = 0; i < DHT22_NUM_BITS; i++) {
+            if (widths[i] > threshold) {
+                high_sum += widths[i];
+                high_count++;
+            } else {
+                low_sum += widths[i];
+                low_count++;
+            }
+        }
+        if (low_count == 0 || high_count == 0) {
+            break;
+        }
+        low_mean = low_sum / low_count;
+        high_mean = high_sum / high_count;
+        threshold = (low_mean + high_mean) / 2;
+    }
+    
+    if (high_mean < low_mean + DHT22_MIN_CLUSTER_GAP_US) {
+        threshold = DHT22_BIT_THRESHOLD;
+    }
+    
+    // Margem: distância do pulso mais próximo do limite, em µs
+    uint32_t margin = UINT32_MAX;
+    for (int i = 0; i < DHT22_NUM_BITS; i++) {
+        uint32_t distance = widths[i] > threshold ? widths[i] - threshold : threshold - widths[i];
+        if (distance < margin) margin = distance;
+    }
+    
+    signal->threshold_us = threshold;
+    signal->margin_us = margin;
+    signal->low_mean_us = low_mean;
+    signal->high_mean_us = high_mean;
+}
+
+// Converte as larguras de pulso medidas nos 5 bytes do quadro, com limite
+// calibrado no próprio quadro
+static void dht22_decode_pulses(dht22_t *dev, uint8_t *data) {
+    dht22_calibrate_threshold(dev->pulse_widths, &dev->signal);
+    
+    for (int i = 0; i < DHT22_NUM_BITS; i++) {
+        if (dev->pulse_widths[i] > dev->signal.threshold_us) {
             data[i / 8] |= (1 << (7 - (i % 8))); // Define bit 1
         }
-        // Para bit 0, não precisa fazer nada (já inicializamos com zeros)
     }
+}
+
+// Dispara a captura (início, resposta e 40 bits) na máquina de estados PIO
+static void dht22_pio_start(dht22_t *dev) {
+    PIO pio = dev->pio;
+    uint sm = dev->sm;
+
+    // Reinicia a SM no começo do programa, com a linha liberada
+    pio_sm_set_enabled(pio, sm, false);
+    pio_sm_clear_fifos(pio, sm);
+    pio_sm_restart(pio, sm);
+    pio_sm_set_consecutive_pindirs(pio, sm, dev->pin, 1, false);
+    pio_sm_exec(pio, sm, pio_encode_jmp(dev->offset));
+
+    dma_channel_transfer_to_buffer_now(dev->dma_chan, dev->pulse_widths, DHT22_NUM_BITS);
+    pio_sm_put(pio, sm, dev->timing.start_low_us - 1);
+    pio_sm_set_enabled(pio, sm, true);
+    dev->capture_start_us = time_us_32();
+    TRACE(TRACE_DHT22_PIO_START, dev->pin);
+}
+
+// Verifica se o PIO/DMA já recebeu os 40 bits
+static inline bool dht22_pio_busy(const dht22_t *dev) {
+    return dma_channel_is_busy(dev->dma_chan);
+}
+
+// Indica se a captura PIO excedeu o tempo máximo do quadro
+static inline bool dht22_pio_timed_out(const dht22_t *dev) {
+    return (time_us_32() - dev->capture_start_us) > (dev->timing.start_low_us + DHT22_FRAME_TIMEOUT_US);
+}
+
+// Encerra a captura PIO e decodifica os dados (ou aborta em caso de timeout)
+static int dht22_pio_finish(dht22_t *dev, uint8_t *data) {
+    PIO pio = dev->pio;
+    uint sm = dev->sm;
+    bool complete = !dht22_pio_busy(dev);
+
+    if (!complete) {
+        dma_channel_abort(dev->dma_chan);
+    }
+    pio_sm_set_enabled(pio, sm, false);
+    pio_sm_set_consecutive_pindirs(pio, sm, dev->pin, 1, false);
+    TRACE(TRACE_DHT22_PIO_FINISH, complete ? DHT22_OK : DHT22_ERROR_TIMEOUT);
+    if (!complete) return DHT22_ERROR_TIMEOUT;
+
+    dht22_decode_pulses(dev, data);
+    return DHT22_OK;
+}
+
+// Realiza a captura completa pela máquina de estados PIO, aguardando o fim do quadro
+static int dht22_capture_pio(dht22_t *dev, uint8_t *data) {
+    dht22_pio_start(dev);
+
+    // O pulso de início e a captura acontecem sem intervenção da CPU
+    while (dht22_pio_busy(dev) && !dht22_pio_timed_out(dev)) {
+        tight_loop_contents();
+    }
+    return dht22_pio_finish(dev, data);
+}
+
+// Captura a resposta e os 40 bits por software, após o pulso de início
+static int RAM_FUNC(dht22_capture_gpio)(dht22_t *dev, uint8_t *data) {
+    int result;
+
+    // Aguarda a resposta do sensor
+    result = dht22_wait_for_response(dev->pin, dev->timing.response_timeout_us);
+    if (result != DHT22_OK) return result;
+
+    // Mede os pulsos e decodifica os dados
+    result = dht22_read_data(dev->pin, dev->pulse_widths);
+    if (result != DHT22_OK) return result;
     
+    dht22_decode_pulses(dev, data);
     return DHT22_OK;
 }
 
@@ -101,60 +328,429 @@ static int dht22_verify_checksum(const uint8_t *data) {
     return DHT22_OK;
 }
 
-// Converte os dados brutos em valores de temperatura e umidade
-static int dht22_convert_data(const uint8_t *data, float *temperature, float *humidity) {
+// Converte os dados brutos em valores de temperatura e umidade (décimos e unidades reais)
+static int dht22_convert_data(const uint8_t *data, bool dht11_frame, int16_t *temperature_x10,
+                              uint16_t *humidity_x10, float *temperature, float *humidity) {
+    // DHT11: partes inteiras nos bytes 0 e 2, faixa de 0 a 50 °C
+    if (dht11_frame) {
+        *humidity_x10 = (uint16_t)(data[0] * 10);
+        *temperature_x10 = (int16_t)(data[2] * 10);
+        if (*humidity_x10 > 1000 || *temperature_x10 > 500) {
+            return DHT22_ERROR_INVALID_DATA;
+        }
+        *humidity = data[0];
+        *temperature = data[2];
+        return DHT22_OK;
+    }
+
     // Calcula umidade
-    *humidity = ((data[0] << 8) | data[1]) * 0.1;
+    *humidity_x10 = (uint16_t)((data[0] << 8) | data[1]);
     
     // Calcula temperatura com sinal
-    *temperature = ((data[2] & 0x7F) << 8 | data[3]) * 0.1;
+    *temperature_x10 = (int16_t)((data[2] & 0x7F) << 8 | data[3]);
     if (data[2] & 0x80) {
-        *temperature *= -1; // Temperatura negativa
+        *temperature_x10 = -*temperature_x10; // Temperatura negativa
     }
     
     // Valida os valores obtidos
-    if (*humidity < 0.0 || *humidity > 100.0 || *temperature < -40.0 || *temperature > 80.0) {
+    if (*humidity_x10 > 1000 || *temperature_x10 < -400 || *temperature_x10 > 800) {
         return DHT22_ERROR_INVALID_DATA;
     }
     
+    *humidity = *humidity_x10 * 0.1f;
+    *temperature = *temperature_x10 * 0.1f;
+    return DHT22_OK;
+}
+
+// Tempo restante (ms) até que o intervalo entre leituras seja respeitado.
+// O intervalo é o mínimo do sensor, ampliado após falhas seguidas.
+static uint32_t dht22_interval_remaining_ms(const dht22_t *dev) {
+    uint32_t current_time = to_ms_since_boot(get_absolute_time());
+    uint32_t elapsed = current_time - dev->last_read_time_ms;
+    if (dev->last_read_time_ms == 0 || elapsed >= dev->interval_ms) {
+        return 0;
+    }
+    return dev->interval_ms - elapsed;
+}
+
+// Contabiliza o resultado de uma tentativa e ajusta o intervalo até a próxima
+static void dht22_record_result(dht22_t *dev, int result) {
+    dev->stats.attempts++;
+    metrics_add(METRICS_DHT22_FRAMES, 1);
+    metrics_add(METRICS_DHT22_ERRORS, result != DHT22_OK);
+    
+    switch (result) {
+    case DHT22_OK:
+        dev->stats.successes++;
+        dev->consecutive_failures = 0;
+        break;
+    case DHT22_ERROR_CHECKSUM:
+        dev->stats.checksum_errors++;
+        dev->consecutive_failures++;
+        break;
+    case DHT22_ERROR_TIMEOUT:
+        dev->stats.timeout_errors++;
+        dev->consecutive_failures++;
+        break;
+    case DHT22_ERROR_INVALID_DATA:
+        dev->stats.invalid_data_errors++;
+        dev->consecutive_failures++;
+        break;
+    default:
+        break;
+    }
+    
+    // Backoff exponencial: intervalo mínimo do perfil após a primeira falha,
+    // dobrando até o limite
+    uint32_t interval = dev->timing.min_interval_ms;
+    for (uint32_t i = 1; i < dev->consecutive_failures && interval < DHT22_MAX_BACKOFF_MS; i++) {
+        interval *= 2;
+    }
+    dev->interval_ms = interval < DHT22_MAX_BACKOFF_MS ? interval : DHT22_MAX_BACKOFF_MS;
+}
+
+// Decide se uma falha deve ser repetida (checksum e timeout costumam ser transitórios)
+static bool dht22_should_retry(dht22_t *dev, int result, uint32_t attempt) {
+    if (result != DHT22_ERROR_CHECKSUM && result != DHT22_ERROR_TIMEOUT) {
+        return false;
+    }
+    if (attempt >= dev->max_retries) {
+        return false;
+    }
+    dev->stats.retries++;
+    return true;
+}
+
+// Etapa final comum: registra o horário, verifica o checksum, converte os dados
+// e contabiliza o resultado
+static int dht22_finish_frame(dht22_t *dev, int result, const uint8_t *data, float *temperature, float *humidity) {
+    // Atualiza o timestamp da última leitura, mesmo em caso de timeout: o
+    // sensor precisa do intervalo mínimo após qualquer tentativa
+    dev->last_read_time_ms = to_ms_since_boot(get_absolute_time());
+    
+    // Verifica o checksum
+    if (result == DHT22_OK) {
+        result = dht22_verify_checksum(data);
+    }
+    
+    // Converte e valida os dados
+    int16_t temperature_x10;
+    uint16_t humidity_x10;
+    if (result == DHT22_OK) {
+        result = dht22_convert_data(data, dev->timing.dht11_frame, &temperature_x10, &humidity_x10, temperature,
+                                    humidity);
+    }
+    
+    dht22_record_result(dev, result);
+    if (result != DHT22_OK) return result;
+    
+    dev->temperature_x10 = temperature_x10;
+    dev->humidity_x10 = humidity_x10;
+    
+    // Cache: temperatura e umidade em uma única palavra, para leitura consistente
+    // por outro núcleo ou fora da interrupção
+    dev->cached_x10 = ((uint32_t)(uint16_t)temperature_x10 << 16) | humidity_x10;
+    dev->cached_time_ms = dev->last_read_time_ms;
+    dev->cache_valid = true;
     return DHT22_OK;
 }
 
+// Realiza uma única tentativa de captura do quadro (bloqueante)
+static int dht22_capture_frame(dht22_t *dev, uint8_t *data) {
+    int result;
+    
+    if (dev->capture == DHT22_CAPTURE_PIO) {
+        // Pulso de início, resposta e dados são tratados pelo PIO
+        return dht22_capture_pio(dev, data);
+    }
+    
+    // Envia o sinal de início
+    result = dht22_send_start_signal(dev->pin, dev->timing.start_low_us);
+    if (result != DHT22_OK) return result;
+    
+    // Aguarda a resposta e lê os dados
+    return dht22_capture_gpio(dev, data);
+}
+
 // Função principal para ler temperatura e umidade do DHT22
-int dht22_read(float *temperature, float *humidity) {
+int dht22_read(dht22_t *dev, float *temperature, float *humidity) {
     int result;
-    uint8_t data[5] = {0};
     
     // Verifica se o driver foi inicializado
-    if (!dht22_state.initialized) {
+    if (!dev->initialized) {
         return DHT22_ERROR_NOT_INITIALIZED;
     }
     
-    // Verifica o intervalo mínimo entre leituras
-    uint32_t current_time = to_ms_since_boot(get_absolute_time());
-    if ((current_time - dht22_state.last_read_time_ms) < DHT22_MIN_INTERVAL_MS && dht22_state.last_read_time_ms != 0) {
-        sleep_ms(DHT22_MIN_INTERVAL_MS - (current_time - dht22_state.last_read_time_ms));
+    // Não interfere em uma leitura assíncrona em andamento
+    if (dev->async_state != DHT22_ASYNC_IDLE) {
+        return DHT22_ERROR_BUSY;
+    }
+    if (dev->powered_off) {
+        return DHT22_ERROR_POWERED_OFF;
     }
     
-    // Envia o sinal de início
-    result = dht22_send_start_signal(dht22_state.pin);
-    if (result != DHT22_OK) return result;
+    TRACE(TRACE_DHT22_READ_BEGIN, dev->pin);
+    for (uint32_t attempt = 0; ; attempt++) {
+        uint8_t data[5] = {0};
+        
+        // Verifica o intervalo entre leituras (mínimo do sensor ou backoff)
+        uint32_t remaining = dht22_interval_remaining_ms(dev);
+        if (remaining > 0) {
+            sleep_ms(remaining);
+        }
+        
+        result = dht22_capture_frame(dev, data);
+        result = dht22_finish_frame(dev, result, data, temperature, humidity);
+        if (!dht22_should_retry(dev, result, attempt)) {
+            TRACE(TRACE_DHT22_READ_END, result);
+            return result;
+        }
+    }
+}
+
+// Conclui uma tentativa assíncrona: agenda uma nova tentativa ou guarda o
+// resultado e notifica o chamador. Retorna o atraso (µs) até a próxima
+// tentativa, ou 0 quando a leitura termina.
+static int64_t dht22_async_complete(dht22_t *dev, int result, const uint8_t *data) {
+    float temperature = 0.0f;
+    float humidity = 0.0f;
     
-    // Aguarda a resposta do sensor
-    result = dht22_wait_for_response(dht22_state.pin);
-    if (result != DHT22_OK) return result;
+    result = dht22_finish_frame(dev, result, data, &temperature, &humidity);
     
-    // Lê os dados
-    result = dht22_read_data(dht22_state.pin, data);
-    if (result != DHT22_OK) return result;
+    if (dht22_should_retry(dev, result, dev->attempt)) {
+        dev->attempt++;
+        dev->async_state = DHT22_ASYNC_WAIT_INTERVAL;
+        int64_t delay_us = (int64_t)dht22_interval_remaining_ms(dev) * 1000;
+        return delay_us > 0 ? delay_us : 1;
+    }
     
-    // Atualiza o timestamp da última leitura
-    dht22_state.last_read_time_ms = to_ms_since_boot(get_absolute_time());
+    dev->async_result = result;
+    dev->temperature = temperature;
+    dev->humidity = humidity;
+    dev->async_state = DHT22_ASYNC_IDLE;
+    dev->result_ready = true;
+    __sev(); // O alarme pode rodar no outro núcleo: acorda quem espera em dht22_read_all()
     
-    // Verifica o checksum
-    result = dht22_verify_checksum(data);
-    if (result != DHT22_OK) return result;
+    if (dev->callback) {
+        dev->callback(result, temperature, humidity, dev->user_data);
+    }
+    return 0;
+}
+
+// Callback do alarme de hardware que avança a máquina de estados da leitura assíncrona.
+// Retorna o atraso (µs, a partir de agora) até a próxima etapa, ou 0 quando a leitura termina.
+static int64_t dht22_alarm_callback(alarm_id_t id, void *user_data) {
+    (void)id;
+    dht22_t *dev = (dht22_t *)user_data;
+    uint8_t data[5] = {0};
     
-    // Converte e valida os dados
-    return dht22_convert_data(data, temperature, humidity);
-}
\ No newline at end of file
+    switch (dev->async_state) {
+    case DHT22_ASYNC_WAIT_INTERVAL:
+        // O PIO gera o pulso de início; verifica o fim do quadro mais tarde
+        dht22_pio_start(dev);
+        dev->async_state = DHT22_ASYNC_CAPTURE;
+        return dev->timing.start_low_us + DHT22_FRAME_POLL_US;
+        
+    case DHT22_ASYNC_CAPTURE:
+        if (dht22_pio_busy(dev) && !dht22_pio_timed_out(dev)) {
+            return DHT22_FRAME_RECHECK_US;
+        }
+        return dht22_async_complete(dev, dht22_pio_finish(dev, data), data);
+        
+    default:
+        return 0;
+    }
+}
+
+// Inicia uma leitura sem bloquear o chamador
+int dht22_read_async(dht22_t *dev, dht22_callback_t callback, void *user_data) {
+    if (!dev->initialized) {
+        return DHT22_ERROR_NOT_INITIALIZED;
+    }
+    if (dev->async_state != DHT22_ASYNC_IDLE) {
+        return DHT22_ERROR_BUSY;
+    }
+    if (dev->powered_off) {
+        return DHT22_ERROR_POWERED_OFF;
+    }
+    if (dev->capture != DHT22_CAPTURE_PIO) {
+        return DHT22_ERROR_UNSUPPORTED; // Captura por software não roda em interrupção
+    }
+    
+    dev->callback = callback;
+    dev->user_data = user_data;
+    dev->attempt = 0;
+    dev->result_ready = false;
+    dev->async_state = DHT22_ASYNC_WAIT_INTERVAL;
+    
+    // O primeiro disparo respeita o intervalo mínimo entre leituras
+    uint64_t delay_us = (uint64_t)dht22_interval_remaining_ms(dev) * 1000;
+    if (add_alarm_in_us(delay_us, dht22_alarm_callback, dev, true) < 0) {
+        dev->async_state = DHT22_ASYNC_IDLE;
+        return DHT22_ERROR_NO_RESOURCES;
+    }
+    
+    return DHT22_OK;
+}
+
+// Indica se o resultado da última leitura assíncrona está disponível
+bool dht22_read_ready(const dht22_t *dev) {
+    return dev->result_ready;
+}
+
+// Obtém o resultado da última leitura assíncrona
+int dht22_get_result(const dht22_t *dev, float *temperature, float *humidity) {
+    if (!dev->result_ready) {
+        return DHT22_ERROR_BUSY;
+    }
+    if (dev->async_result == DHT22_OK) {
+        *temperature = dev->temperature;
+        *humidity = dev->humidity;
+    }
+    return dev->async_result;
+}
+
+// Obtém o resultado da última leitura assíncrona em décimos, sem ponto flutuante
+int dht22_get_result_x10(const dht22_t *dev, int16_t *temperature_x10, uint16_t *humidity_x10) {
+    if (!dev->result_ready) {
+        return DHT22_ERROR_BUSY;
+    }
+    if (dev->async_result == DHT22_OK) {
+        *temperature_x10 = dev->temperature_x10;
+        *humidity_x10 = dev->humidity_x10;
+    }
+    return dev->async_result;
+}
+
+// Lê vários sensores em paralelo, aguardando a conclusão de todos
+int dht22_read_all(dht22_t *const *devs, size_t count) {
+    int first_error = DHT22_OK;
+    
+    // Dispara as leituras PIO; os quadros correm simultaneamente
+    for (size_t i = 0; i < count; i++) {
+        if (devs[i]->capture != DHT22_CAPTURE_PIO) {
+            continue;
+        }
+        int result = dht22_read_async(devs[i], NULL, NULL);
+        // DHT22_ERROR_BUSY: a leitura em andamento publica o próprio resultado
+        if (result != DHT22_OK && result != DHT22_ERROR_BUSY) {
+            devs[i]->async_result = result;
+            devs[i]->result_ready = true;
+        }
+    }
+    
+    // Captura por software: aqui, fora de interrupção, enquanto os quadros PIO chegam
+    for (size_t i = 0; i < count; i++) {
+        if (devs[i]->capture == DHT22_CAPTURE_PIO) {
+            continue;
+        }
+        float temperature, humidity;
+        devs[i]->result_ready = false;
+        devs[i]->async_result = dht22_read(devs[i], &temperature, &humidity);
+        if (devs[i]->async_result == DHT22_OK) {
+            devs[i]->temperature = temperature;
+            devs[i]->humidity = humidity;
+        }
+        devs[i]->result_ready = true;
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        while (!devs[i]->result_ready) {
+            __wfe(); // Acordado pelo __sev() ao fim da leitura
+        }
+        if (first_error == DHT22_OK && devs[i]->async_result != DHT22_OK) {
+            first_error = devs[i]->async_result;
+        }
+    }
+    
+    return first_error;
+}
+
+// Retorna imediatamente a última leitura válida e sua idade
+int dht22_read_cached(dht22_t *dev, float *temperature, float *humidity, uint32_t *age_ms) {
+    if (!dev->initialized) {
+        return DHT22_ERROR_NOT_INITIALIZED;
+    }
+    
+    bool valid = dev->cache_valid;
+    uint32_t cached_x10 = dev->cached_x10;
+    uint32_t age = to_ms_since_boot(get_absolute_time()) - dev->cached_time_ms;
+    
+    // Atualiza em segundo plano quando o valor estiver velho demais (ou ausente)
+    if (dev->max_age_ms != 0 && (!valid || age > dev->max_age_ms) && dev->async_state == DHT22_ASYNC_IDLE) {
+        dht22_read_async(dev, NULL, NULL);
+    }
+    
+    if (!valid) {
+        return DHT22_ERROR_NO_DATA;
+    }
+    
+    *temperature = (int16_t)(cached_x10 >> 16) * 0.1f;
+    *humidity = (uint16_t)cached_x10 * 0.1f;
+    if (age_ms) {
+        *age_ms = age;
+    }
+    return DHT22_OK;
+}
+
+// Define a idade máxima do cache antes de uma atualização em segundo plano
+void dht22_set_max_age(dht22_t *dev, uint32_t max_age_ms) {
+    dev->max_age_ms = max_age_ms;
+}
+
+// Define o número máximo de novas tentativas por leitura
+void dht22_set_max_retries(dht22_t *dev, uint32_t max_retries) {
+    dev->max_retries = max_retries;
+}
+
+// Copia as estatísticas de leitura, com a taxa de sucesso calculada
+void dht22_get_stats(const dht22_t *dev, dht22_stats_t *stats) {
+    *stats = dev->stats;
+    stats->success_permille = stats->attempts ? (uint32_t)((uint64_t)stats->successes * 1000 / stats->attempts) : 0;
+}
+
+// Zera as estatísticas de leitura
+void dht22_reset_stats(dht22_t *dev) {
+    dev->stats = (dht22_stats_t){0};
+}
+
+// Copia a qualidade de sinal do último quadro capturado
+void dht22_get_signal(const dht22_t *dev, dht22_signal_t *signal) {
+    *signal = dev->signal;
+}
+
+// Seleciona o perfil de temporização do sensor
+int dht22_set_profile(dht22_t *dev, dht22_profile_t profile) {
+    if ((unsigned)profile >= count_of(dht22_profiles)) {
+        return DHT22_ERROR_INVALID_DATA;
+    }
+    if (dev->async_state != DHT22_ASYNC_IDLE) {
+        return DHT22_ERROR_BUSY;
+    }
+    dev->timing = dht22_profiles[profile];
+    dev->interval_ms = dev->timing.min_interval_ms;
+    dev->consecutive_failures = 0;
+    return DHT22_OK;
+}
+
+// Ajusta a linha de dados ao estado da alimentação do sensor
+int dht22_set_powered(dht22_t *dev, bool powered) {
+    if (!dev->initialized) {
+        return DHT22_ERROR_NOT_INITIALIZED;
+    }
+    if (dev->async_state != DHT22_ASYNC_IDLE) {
+        return DHT22_ERROR_BUSY;
+    }
+
+    if (powered) {
+        gpio_set_input_enabled(dev->pin, true);
+        gpio_set_pulls(dev->pin, true, false); // Habilita pull-up
+    } else {
+        // Sem pull-up o sensor não é alimentado pela linha; sem buffer de entrada
+        // a linha flutuante não consome corrente
+        gpio_disable_pulls(dev->pin);
+        gpio_set_input_enabled(dev->pin, false);
+    }
+    dev->powered_off = !powered;
+    return DHT22_OK;
+}
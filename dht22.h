@@ -1,7 +1,11 @@
 #ifndef DHT22_H
 #define DHT22_H
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include "pico/time.h"
+#include "hardware/pio.h"
 
 // Códigos de retorno para as operações do driver DHT22
 #define DHT22_OK 0                        // Operação bem-sucedida
@@ -9,17 +13,144 @@
 #define DHT22_ERROR_TIMEOUT -2            // Timeout na comunicação com o sensor
 #define DHT22_ERROR_INVALID_DATA -3       // Dados fora dos limites físicos válidos
 #define DHT22_ERROR_NOT_INITIALIZED -4    // Driver não foi inicializado
+#define DHT22_ERROR_NO_RESOURCES -5       // Sem máquina de estados PIO, canal DMA ou alarme livre
+#define DHT22_ERROR_BUSY -6               // Já existe uma leitura assíncrona em andamento
+#define DHT22_ERROR_NO_DATA -7            // Nenhuma leitura válida em cache ainda
+#define DHT22_ERROR_POWERED_OFF -8        // Alimentação desligada com dht22_set_powered()
+#define DHT22_ERROR_UNSUPPORTED -9        // Leitura assíncrona com captura DHT22_CAPTURE_GPIO
+
+// Modos de captura do quadro de 40 bits
+typedef enum {
+    DHT22_CAPTURE_GPIO,  // Bit-banging por software (CPU ocupada ~5ms por leitura)
+    DHT22_CAPTURE_PIO    // Máquina de estados PIO + DMA (imune a jitter de interrupções)
+} dht22_capture_t;
+
+#define DHT22_NUM_BITS 40                 // Bits por quadro (5 bytes)
+#define DHT22_MIN_INTERVAL_MS 2000        // Intervalo mínimo entre leituras (2 segundos)
+#define DHT22_DEFAULT_MAX_RETRIES 2       // Novas tentativas por leitura após checksum/timeout
+#define DHT22_POWER_UP_MS 1000            // Espera após ligar a alimentação antes do primeiro quadro
+
+/**
+   Perfis de temporização do protocolo.
+
+   O DHT22/AM2302 responde a um pulso de início de 1ms; os 18ms do datasheet
+   do DHT11 apenas atrasam cada leitura. DHT22_PROFILE_DHT11 também troca o
+   formato do quadro: umidade e temperatura inteiras nos bytes 0 e 2, sem
+   sinal, com os limites do DHT11 (0 a 50 °C). Os valores em décimos saem
+   sempre múltiplos de 10.
+*/
+typedef enum {
+    DHT22_PROFILE_DHT11,         // Início de 18ms, intervalo de 1s, quadro do DHT11
+    DHT22_PROFILE_DHT22,         // Início de 1,1ms, intervalo de 2s (padrão)
+    DHT22_PROFILE_CONSERVATIVE   // Início de 18ms, resposta tolerante, intervalo de 2,5s
+} dht22_profile_t;
+
+// Temporização efetiva de um perfil
+typedef struct {
+    uint32_t start_low_us;       // Duração do pulso LOW de início
+    uint32_t response_timeout_us; // Espera máxima por cada fase da resposta
+    uint32_t min_interval_ms;    // Intervalo mínimo entre leituras
+    bool dht11_frame;            // Quadro do DHT11: valores inteiros nos bytes 0 e 2
+} dht22_timing_t;
+
+// Estatísticas de leitura de um sensor, para ajuste da política de tentativas
+typedef struct {
+    uint32_t attempts;           // Quadros solicitados ao sensor (incluindo novas tentativas)
+    uint32_t successes;          // Quadros válidos
+    uint32_t checksum_errors;    // Falhas de checksum
+    uint32_t timeout_errors;     // Sensor não respondeu a tempo
+    uint32_t invalid_data_errors;// Valores fora dos limites físicos
+    uint32_t retries;            // Novas tentativas automáticas
+    uint32_t success_permille;   // Taxa de sucesso em ‰ (calculada por dht22_get_stats)
+} dht22_stats_t;
+
+// Qualidade de sinal do último quadro, calculada a partir das 40 larguras de pulso
+typedef struct {
+    uint32_t threshold_us;       // Limite entre bit 0 e bit 1 escolhido para o quadro
+    uint32_t margin_us;          // Distância do pulso mais próximo do limite (maior = mais robusto)
+    uint32_t low_mean_us;        // Largura média dos bits 0
+    uint32_t high_mean_us;       // Largura média dos bits 1
+} dht22_signal_t;
+
+/**
+   Callback de conclusão de uma leitura assíncrona.
+
+   É chamado a partir do callback do alarme de hardware (contexto de
+   interrupção), portanto deve ser curto e não pode bloquear.
+
+   result: Código de retorno da leitura (mesmos códigos de dht22_read)
+   temperature: Temperatura lida em °C (válida apenas se result == DHT22_OK)
+   humidity: Umidade lida em % (válida apenas se result == DHT22_OK)
+   user_data: Ponteiro repassado em dht22_read_async()
+*/
+typedef void (*dht22_callback_t)(int result, float temperature, float humidity, void *user_data);
+
+// Etapas da leitura assíncrona, avançadas pelo callback do alarme
+typedef enum {
+    DHT22_ASYNC_IDLE,           // Nenhuma leitura em andamento
+    DHT22_ASYNC_WAIT_INTERVAL,  // Aguardando o intervalo mínimo entre leituras
+    DHT22_ASYNC_CAPTURE         // Quadro sendo capturado pelo PIO
+} dht22_async_state_t;
+
+/**
+   Instância do driver, uma por sensor.
+
+   A memória é fornecida pelo chamador (normalmente uma variável estática) e
+   deve permanecer válida enquanto o sensor estiver em uso. Os campos são
+   internos ao driver e não devem ser acessados diretamente.
+*/
+typedef struct {
+    uint32_t last_read_time_ms;  // Timestamp da última leitura
+    uint32_t pin;                // Pino GPIO usado para comunicação
+    bool initialized;            // Indicador de inicialização
+    dht22_capture_t capture;     // Modo de captura escolhido em dht22_init()
+    dht22_timing_t timing;       // Temporização do perfil selecionado
+    PIO pio;                     // Bloco PIO (modo PIO)
+    uint sm;                     // Máquina de estados reservada (modo PIO)
+    uint offset;                 // Endereço do programa na memória do PIO
+    int dma_chan;                // Canal DMA que drena a RX FIFO (modo PIO)
+    uint32_t pulse_widths[DHT22_NUM_BITS]; // Larguras dos pulsos HIGH em µs
+    dht22_signal_t signal;       // Limite e margem do último quadro
+    volatile dht22_async_state_t async_state; // Etapa da leitura assíncrona
+    volatile bool result_ready;  // Resultado da leitura assíncrona disponível
+    int async_result;            // Código de retorno da última leitura assíncrona
+    float temperature;           // Temperatura da última leitura assíncrona
+    float humidity;              // Umidade da última leitura assíncrona
+    int16_t temperature_x10;     // Última temperatura válida em décimos de °C
+    uint16_t humidity_x10;       // Última umidade válida em décimos de %
+    volatile uint32_t cached_x10; // Cache: temperatura (16 bits altos) e umidade (baixos)
+    volatile uint32_t cached_time_ms; // Horário da leitura em cache
+    volatile bool cache_valid;   // Cache contém uma leitura válida
+    uint32_t max_age_ms;         // Idade que dispara atualização em segundo plano (0 = nunca)
+    uint32_t interval_ms;        // Intervalo exigido antes da próxima tentativa
+    uint32_t consecutive_failures; // Falhas seguidas (define o backoff)
+    uint32_t max_retries;        // Novas tentativas permitidas por leitura
+    uint32_t attempt;            // Tentativa atual da leitura assíncrona
+    dht22_stats_t stats;         // Contadores de leitura
+    uint32_t capture_start_us;   // Início da captura PIO (para timeout)
+    dht22_callback_t callback;   // Callback de conclusão
+    void *user_data;             // Contexto repassado ao callback
+    bool powered_off;            // Alimentação desligada: linha sem pull-up
+} dht22_t;
 
 /**
    Inicializa o driver DHT22 para o pino especificado.
 
    Esta função deve ser chamada antes de qualquer operação de leitura.
-   Configura o pino GPIO e inicializa o estado interno do driver.
+   Configura o pino GPIO e inicializa o estado da instância. Cada sensor
+   usa sua própria instância e seu próprio pino.
+
+   No modo DHT22_CAPTURE_PIO, uma máquina de estados livre (pio0 ou pio1) e
+   um canal DMA são reservados: o PIO gera o pulso de início e mede a largura
+   de cada pulso em hardware, e o DMA transfere as medidas para a RAM.
 
+   dev: Instância do driver a ser inicializada
    pin: Número do pino GPIO conectado ao sensor DHT22
+   capture: Modo de captura (DHT22_CAPTURE_GPIO ou DHT22_CAPTURE_PIO)
    Retorna: DHT22_OK em caso de sucesso
+            DHT22_ERROR_NO_RESOURCES se não houver SM/programa/DMA disponível
 */
-int dht22_init(uint32_t pin);
+int dht22_init(dht22_t *dev, uint32_t pin, dht22_capture_t capture);
 
 /**
    Realiza uma leitura completa do sensor DHT22.
@@ -28,10 +159,16 @@ int dht22_init(uint32_t pin);
    incluindo o envio do sinal de início, leitura dos dados, verificação
    de checksum e conversão para valores reais de temperatura e umidade.
 
-   Respeita automaticamente o intervalo mínimo de 2 segundos entre leituras
-   recomendado pelo fabricante. Se chamada antes desse intervalo, a função
+   Respeita automaticamente o intervalo mínimo entre leituras do perfil de
+   temporização (2 segundos no perfil padrão). Se chamada antes desse intervalo, a função
    aguardará o tempo necessário.
 
+   Falhas de checksum ou timeout são repetidas automaticamente até o limite
+   definido em dht22_set_max_retries(). Após falhas seguidas, o intervalo
+   entre tentativas dobra (2s, 4s, 8s, até 16s no perfil padrão) e volta ao mínimo no
+   primeiro sucesso, evitando rajadas de tentativas contra o sensor.
+
+   dev: Instância do sensor
    temperature: Ponteiro para armazenar a temperatura lida (em °C)
    humidity: Ponteiro para armazenar a umidade lida (em %)
 
@@ -41,7 +178,196 @@ int dht22_init(uint32_t pin);
      DHT22_ERROR_TIMEOUT - Timeout na comunicação
      DHT22_ERROR_INVALID_DATA - Dados fora dos limites válidos
      DHT22_ERROR_NOT_INITIALIZED - Driver não inicializado
+     DHT22_ERROR_BUSY - Leitura assíncrona em andamento
+     DHT22_ERROR_POWERED_OFF - Alimentação desligada
+*/
+int dht22_read(dht22_t *dev, float *temperature, float *humidity);
+
+/**
+   Inicia uma leitura do sensor DHT22 sem bloquear o chamador.
+
+   A leitura é conduzida por um alarme de hardware: o primeiro disparo
+   respeita o intervalo mínimo entre leituras e inicia a captura pelo PIO;
+   os seguintes apenas verificam o fim do quadro. Ao final, o callback é
+   chamado e a flag consultada por dht22_read_ready() é ativada.
+
+   Exige DHT22_CAPTURE_PIO. A captura por software espera ativamente os
+   ~5ms do quadro e, dentro do callback do alarme (interrupção, em geral no
+   núcleo 0), atrasaria os outros alarmes e as interrupções do HX711 e da
+   USB; no modo DHT22_CAPTURE_GPIO, use dht22_read().
+
+   dev: Instância do sensor
+   callback: Função chamada ao final da leitura (pode ser NULL para usar só a flag)
+   user_data: Ponteiro repassado ao callback
+
+   Retorna:
+     DHT22_OK - Leitura iniciada
+     DHT22_ERROR_BUSY - Já existe uma leitura em andamento
+     DHT22_ERROR_NO_RESOURCES - Nenhum alarme de hardware disponível
+     DHT22_ERROR_NOT_INITIALIZED - Driver não inicializado
+     DHT22_ERROR_POWERED_OFF - Alimentação desligada
+     DHT22_ERROR_UNSUPPORTED - Sensor inicializado com DHT22_CAPTURE_GPIO
+*/
+int dht22_read_async(dht22_t *dev, dht22_callback_t callback, void *user_data);
+
+/**
+   Indica se o resultado da última leitura assíncrona está disponível.
+
+   dev: Instância do sensor
+   Retorna: true após a conclusão da leitura, até que outra seja iniciada
+*/
+bool dht22_read_ready(const dht22_t *dev);
+
+/**
+   Obtém o resultado da última leitura assíncrona concluída.
+
+   dev: Instância do sensor
+   temperature: Ponteiro para armazenar a temperatura lida (em °C)
+   humidity: Ponteiro para armazenar a umidade lida (em %)
+
+   Retorna o código da leitura (mesmos códigos de dht22_read), ou
+   DHT22_ERROR_BUSY se nenhum resultado estiver disponível ainda.
+*/
+int dht22_get_result(const dht22_t *dev, float *temperature, float *humidity);
+
+/**
+   Obtém o resultado da última leitura assíncrona em décimos, sem float.
+
+   Os valores são os campos brutos do quadro do sensor (×10), úteis para
+   transporte e armazenamento compactos.
+
+   dev: Instância do sensor
+   temperature_x10: Ponteiro para a temperatura em décimos de °C
+   humidity_x10: Ponteiro para a umidade em décimos de %
+
+   Retorna os mesmos códigos de dht22_get_result().
+*/
+int dht22_get_result_x10(const dht22_t *dev, int16_t *temperature_x10, uint16_t *humidity_x10);
+
+/**
+   Lê vários sensores ao mesmo tempo, bloqueando até que todos terminem.
+
+   As leituras com captura PIO são disparadas de forma assíncrona antes de
+   aguardar qualquer uma delas: os quadros são recebidos em paralelo e o
+   tempo total é próximo ao de uma única leitura. Sensores com captura
+   DHT22_CAPTURE_GPIO são lidos em seguida, um a um, com dht22_read() no
+   contexto do chamador. O resultado de cada sensor fica disponível em
+   dht22_get_result().
+
+   A espera inclui as novas tentativas e o backoff (dezenas de segundos com
+   um sensor desconectado); o núcleo dorme em WFE enquanto isso. Em um
+   núcleo com outras tarefas, prefira dht22_read_async() com um callback.
+
+   devs: Vetor de instâncias inicializadas
+   count: Número de instâncias no vetor
+
+   Retorna DHT22_OK se todas as leituras tiverem sucesso, ou o código de
+   erro do primeiro sensor que falhou.
+*/
+int dht22_read_all(dht22_t *const *devs, size_t count);
+
+/**
+   Retorna imediatamente a última leitura válida, sem aguardar o sensor.
+
+   Ao contrário de dht22_read(), nunca espera o intervalo mínimo nem o
+   quadro do sensor. Se uma idade máxima tiver sido definida com
+   dht22_set_max_age() e o valor em cache for mais velho que ela, uma
+   leitura assíncrona é iniciada em segundo plano e a próxima consulta já
+   recebe o valor novo. No modo DHT22_CAPTURE_GPIO não há leitura em
+   segundo plano (veja dht22_read_async()): o cache só é renovado por
+   dht22_read().
+
+   dev: Instância do sensor
+   temperature: Ponteiro para armazenar a temperatura em cache (em °C)
+   humidity: Ponteiro para armazenar a umidade em cache (em %)
+   age_ms: Ponteiro para a idade do valor em ms (pode ser NULL)
+
+   Retorna:
+     DHT22_OK - Valor em cache retornado
+     DHT22_ERROR_NO_DATA - Ainda não há leitura válida
+     DHT22_ERROR_NOT_INITIALIZED - Driver não inicializado
+*/
+int dht22_read_cached(dht22_t *dev, float *temperature, float *humidity, uint32_t *age_ms);
+
+/**
+   Define a idade máxima do cache antes de uma atualização em segundo plano.
+
+   dev: Instância do sensor
+   max_age_ms: Idade máxima em ms (0 desativa a atualização automática)
+*/
+void dht22_set_max_age(dht22_t *dev, uint32_t max_age_ms);
+
+/**
+   Define o número máximo de novas tentativas por leitura.
+
+   Vale para dht22_read() e dht22_read_async(). Cada nova tentativa
+   respeita o intervalo mínimo e o backoff, portanto pode levar segundos.
+
+   dev: Instância do sensor
+   max_retries: Novas tentativas após checksum/timeout (0 desativa)
+*/
+void dht22_set_max_retries(dht22_t *dev, uint32_t max_retries);
+
+/**
+   Copia as estatísticas de leitura do sensor.
+
+   dev: Instância do sensor
+   stats: Destino das estatísticas (success_permille é calculado aqui)
+*/
+void dht22_get_stats(const dht22_t *dev, dht22_stats_t *stats);
+
+/**
+   Zera as estatísticas de leitura do sensor.
+
+   dev: Instância do sensor
+*/
+void dht22_reset_stats(dht22_t *dev);
+
+/**
+   Retorna a qualidade de sinal do último quadro capturado.
+
+   O limite entre bit 0 e bit 1 é recalculado a cada quadro a partir das
+   larguras medidas, compensando sensores clones, cabos longos e deriva
+   térmica. Uma margem pequena (poucos µs) indica que o sinal está
+   degradado e que falhas de checksum estão próximas.
+
+   dev: Instância do sensor
+   signal: Destino do limite, da margem e das larguras médias
+*/
+void dht22_get_signal(const dht22_t *dev, dht22_signal_t *signal);
+
+/**
+   Seleciona o perfil de temporização do sensor.
+
+   dht22_init() seleciona DHT22_PROFILE_DHT22, cujo pulso de início de 1,1ms
+   encurta cada leitura em ~17ms em relação aos 18ms do DHT11. Use
+   DHT22_PROFILE_CONSERVATIVE para clones que não respondem ao pulso curto
+   e DHT22_PROFILE_DHT11 para sensores DHT11, que também decodifica o quadro
+   no formato do DHT11.
+
+   dev: Instância do sensor
+   profile: Perfil de temporização
+   Retorna: DHT22_OK em caso de sucesso
+            DHT22_ERROR_INVALID_DATA se o perfil for desconhecido
+            DHT22_ERROR_BUSY se houver leitura assíncrona em andamento
+*/
+int dht22_set_profile(dht22_t *dev, dht22_profile_t profile);
+
+/**
+   Informa ao driver que a alimentação do sensor foi ligada ou desligada.
+
+   Com o sensor sem alimentação, o pull-up da linha de dados o manteria
+   alimentado parcialmente pelo pino: ao desligar, o pull-up e o buffer de
+   entrada do pino são desativados e as leituras retornam
+   DHT22_ERROR_POWERED_OFF. Quem chaveia a alimentação deve aguardar
+   DHT22_POWER_UP_MS após ligá-la antes da próxima leitura.
+
+   dev: Instância do sensor
+   powered: true após ligar a alimentação, false antes de desligá-la
+   Retorna: DHT22_OK em caso de sucesso
+            DHT22_ERROR_NOT_INITIALIZED se o driver não foi inicializado
+            DHT22_ERROR_BUSY se houver leitura assíncrona em andamento
 */
-int dht22_read(float *temperature, float *humidity);
+int dht22_set_powered(dht22_t *dev, bool powered);
 
 #endif // DHT22_H
\ No newline at end of file
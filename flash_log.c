@@ -0,0 +1,333 @@
+#include "flash_log.h"
+#include "crc32.h"
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+#include <stddef.h>
+#include <string.h>
+
+// Geometria da região do log
+#define FLASH_LOG_PAGES_PER_SECTOR (FLASH_SECTOR_SIZE / FLASH_LOG_PAGE_SIZE)
+#define FLASH_LOG_TOTAL_PAGES (FLASH_LOG_SECTORS * FLASH_LOG_PAGES_PER_SECTOR)
+#define FLASH_LOG_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE - FLASH_LOG_SECTORS * FLASH_SECTOR_SIZE)
+
+#define FLASH_LOG_MAGIC 0x474C            // "LG"
+#define FLASH_LOG_PENDING 0xFF            // Página ainda não consumida (estado apagado)
+#define FLASH_LOG_CONSUMED 0x00           // Página consumida (byte programado)
+#define FLASH_LOG_SAFE_TIMEOUT_MS 100     // Espera máxima para pausar o outro núcleo
+#define FLASH_LOG_MARK_BATCH 16           // Páginas marcadas por pausa da flash
+
+// Cabeçalho gravado no início de cada página
+typedef struct __attribute__((packed)) {
+    uint16_t magic;              // FLASH_LOG_MAGIC
+    uint16_t length;             // Bytes úteis do registro
+    uint32_t seq;                // Número de sequência (cresce a cada página)
+    uint32_t crc;                // CRC-32 de magic, length, seq e dos dados
+    uint8_t consumed;            // FLASH_LOG_PENDING ou FLASH_LOG_CONSUMED
+    uint8_t reserved[3];         // Mantidos em 0xFF
+} flash_log_header_t;
+
+_Static_assert(sizeof(flash_log_header_t) == FLASH_LOG_HEADER_SIZE, "cabeçalho do log deve ter FLASH_LOG_HEADER_SIZE bytes");
+_Static_assert(FLASH_LOG_PAGE_SIZE == FLASH_PAGE_SIZE, "o log grava páginas inteiras da flash");
+_Static_assert(FLASH_LOG_STAGE_PAGES >= 1 && FLASH_LOG_STAGE_PAGES <= FLASH_LOG_PAGES_PER_SECTOR,
+               "FLASH_LOG_STAGE_PAGES deve caber em um setor");
+
+// Estado do log
+typedef struct {
+    bool initialized;            // Indicador de inicialização
+    uint32_t write_page;         // Próxima página a programar
+    uint32_t read_page;          // Página pendente mais antiga
+    uint32_t pending;            // Páginas programadas e não consumidas
+    uint32_t next_seq;           // Sequência da próxima página
+    uint32_t overwritten;        // Páginas não lidas perdidas na sobrescrita
+    uint32_t staged;             // Páginas montadas em RAM
+    uint8_t staging[FLASH_LOG_STAGE_PAGES * FLASH_LOG_PAGE_SIZE] __attribute__((aligned(4))); // Páginas em RAM
+} flash_log_state_t;
+
+// Programação solicitada a flash_safe_execute()
+typedef struct {
+    uint32_t page;               // Primeira página
+    uint32_t count;              // Número de páginas
+    const uint8_t *data;         // Conteúdo (count páginas) ou NULL para marcar como consumidas
+} flash_log_program_t;
+
+static flash_log_state_t flash_log_state;
+
+// Fim do binário gravado na flash (definido pelo linker script do SDK)
+extern char __flash_binary_end;
+
+static inline uint32_t flash_log_page_offset(uint32_t page) {
+    return FLASH_LOG_OFFSET + page * FLASH_LOG_PAGE_SIZE;
+}
+
+static inline const uint8_t *flash_log_page_ptr(uint32_t page) {
+    return (const uint8_t *)(uintptr_t)(XIP_BASE + flash_log_page_offset(page));
+}
+
+static inline uint32_t flash_log_next(uint32_t page, uint32_t n) {
+    return (page + n) % FLASH_LOG_TOTAL_PAGES;
+}
+
+// CRC do cabeçalho (sem os campos crc e consumed) e dos dados
+static uint32_t flash_log_crc(const flash_log_header_t *header, const uint8_t *payload) {
+    uint32_t crc = crc32_update(CRC32_INIT, header, offsetof(flash_log_header_t, crc));
+    return crc32_update(crc, payload, header->length);
+}
+
+// Verifica se uma página gravada contém um registro íntegro
+static bool flash_log_page_valid(const uint8_t *page) {
+    flash_log_header_t header;
+    memcpy(&header, page, sizeof(header));
+
+    if (header.magic != FLASH_LOG_MAGIC || header.length == 0 || header.length > FLASH_LOG_PAGE_PAYLOAD) {
+        return false;
+    }
+    return flash_log_crc(&header, page + FLASH_LOG_HEADER_SIZE) == header.crc;
+}
+
+// Verifica se o cabeçalho de uma página ainda está apagado
+static bool flash_log_page_erased(const uint8_t *page) {
+    for (uint32_t i = 0; i < FLASH_LOG_HEADER_SIZE; i++) {
+        if (page[i] != 0xFF) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Executada com o outro núcleo pausado e as interrupções desabilitadas
+static void flash_log_do_program(void *param) {
+    const flash_log_program_t *program = param;
+    uint32_t page = program->page;
+    uint32_t left = program->count;
+    const uint8_t *data = program->data;
+
+    if (data == NULL) {
+        // Marca páginas como consumidas: 0xFF não altera os bytes já programados
+        uint8_t mark[FLASH_LOG_PAGE_SIZE] __attribute__((aligned(4)));
+        memset(mark, 0xFF, sizeof(mark));
+        mark[offsetof(flash_log_header_t, consumed)] = FLASH_LOG_CONSUMED;
+        for (; left > 0; left--, page = flash_log_next(page, 1)) {
+            flash_range_program(flash_log_page_offset(page), mark, sizeof(mark));
+        }
+        return;
+    }
+
+    while (left > 0) {
+        uint32_t in_sector = page % FLASH_LOG_PAGES_PER_SECTOR;
+        uint32_t n = FLASH_LOG_PAGES_PER_SECTOR - in_sector;
+        if (n > left) n = left;
+
+        // Cada setor é apagado somente quando a escrita chega ao seu início
+        if (in_sector == 0) {
+            flash_range_erase(flash_log_page_offset(page), FLASH_SECTOR_SIZE);
+        }
+        flash_range_program(flash_log_page_offset(page), data, n * FLASH_LOG_PAGE_SIZE);
+
+        page = flash_log_next(page, n);
+        data += n * FLASH_LOG_PAGE_SIZE;
+        left -= n;
+    }
+}
+
+// Descarta as páginas pendentes do setor que será apagado a partir de page
+static void flash_log_account_erase(uint32_t page) {
+    flash_log_state_t *log = &flash_log_state;
+    uint32_t into_sector = (log->read_page + FLASH_LOG_TOTAL_PAGES - page) % FLASH_LOG_TOTAL_PAGES;
+
+    if (log->pending == 0 || into_sector >= FLASH_LOG_PAGES_PER_SECTOR) {
+        return;
+    }
+    uint32_t lost = FLASH_LOG_PAGES_PER_SECTOR - into_sector;
+    if (lost > log->pending) lost = log->pending;
+
+    log->read_page = flash_log_next(log->read_page, lost);
+    log->pending -= lost;
+    log->overwritten += lost;
+}
+
+// Grava as páginas montadas em RAM
+static int flash_log_commit(void) {
+    flash_log_state_t *log = &flash_log_state;
+    flash_log_program_t program = {log->write_page, log->staged, log->staging};
+
+    if (log->staged == 0) {
+        return FLASH_LOG_OK;
+    }
+    if (flash_safe_execute(flash_log_do_program, &program, FLASH_LOG_SAFE_TIMEOUT_MS) != PICO_OK) {
+        return FLASH_LOG_ERROR_FLASH; // As páginas continuam em RAM para a próxima tentativa
+    }
+
+    // Setores apagados durante a gravação levam consigo registros não lidos
+    for (uint32_t i = 0; i < log->staged; i++) {
+        uint32_t page = flash_log_next(log->write_page, i);
+        if (page % FLASH_LOG_PAGES_PER_SECTOR == 0) {
+            flash_log_account_erase(page);
+        }
+    }
+
+    log->write_page = flash_log_next(log->write_page, log->staged);
+    log->pending += log->staged;
+    log->staged = 0;
+    return FLASH_LOG_OK;
+}
+
+// Inicializa o log e recupera o estado gravado
+int flash_log_init(void) {
+    flash_log_state_t *log = &flash_log_state;
+    bool found = false;
+    uint32_t newest = 0;
+    uint32_t newest_seq = 0;
+
+    memset(log, 0, offsetof(flash_log_state_t, staging));
+
+    if ((uintptr_t)&__flash_binary_end - XIP_BASE > FLASH_LOG_OFFSET) {
+        return FLASH_LOG_ERROR_NO_SPACE;
+    }
+
+    // Página mais nova: maior sequência (com comparação tolerante a estouro)
+    for (uint32_t page = 0; page < FLASH_LOG_TOTAL_PAGES; page++) {
+        const uint8_t *ptr = flash_log_page_ptr(page);
+        if (!flash_log_page_valid(ptr)) {
+            continue;
+        }
+        uint32_t seq = ((const flash_log_header_t *)ptr)->seq;
+        if (!found || (int32_t)(seq - newest_seq) > 0) {
+            found = true;
+            newest = page;
+            newest_seq = seq;
+        }
+    }
+
+    log->next_seq = found ? newest_seq + 1 : 1;
+    log->write_page = found ? flash_log_next(newest, 1) : 0;
+
+    // Uma gravação interrompida deixa a página seguinte suja: recomeça no próximo setor
+    if (log->write_page % FLASH_LOG_PAGES_PER_SECTOR != 0 && !flash_log_page_erased(flash_log_page_ptr(log->write_page))) {
+        uint32_t skip = FLASH_LOG_PAGES_PER_SECTOR - log->write_page % FLASH_LOG_PAGES_PER_SECTOR;
+        log->write_page = flash_log_next(log->write_page, skip);
+    }
+
+    // Pendentes: sequência contínua de páginas não consumidas terminando na mais nova
+    if (found) {
+        uint32_t page = newest;
+        uint32_t seq = newest_seq;
+        while (log->pending < FLASH_LOG_TOTAL_PAGES) {
+            const uint8_t *ptr = flash_log_page_ptr(page);
+            const flash_log_header_t *header = (const flash_log_header_t *)ptr;
+            if (!flash_log_page_valid(ptr) || header->seq != seq || header->consumed != FLASH_LOG_PENDING) {
+                break;
+            }
+            log->pending++;
+            page = (page + FLASH_LOG_TOTAL_PAGES - 1) % FLASH_LOG_TOTAL_PAGES;
+            seq--;
+        }
+    }
+    log->read_page = found ? (newest + FLASH_LOG_TOTAL_PAGES + 1 - log->pending) % FLASH_LOG_TOTAL_PAGES : 0;
+    log->initialized = true;
+    return FLASH_LOG_OK;
+}
+
+// Monta o registro em uma página em RAM; grava quando um setor estiver completo
+int flash_log_append(const uint8_t *data, uint32_t length) {
+    flash_log_state_t *log = &flash_log_state;
+
+    if (!log->initialized) {
+        return FLASH_LOG_ERROR_NOT_INITIALIZED;
+    }
+    if (length == 0 || length > FLASH_LOG_PAGE_PAYLOAD) {
+        return FLASH_LOG_ERROR_TOO_LARGE;
+    }
+    if (log->staged == FLASH_LOG_STAGE_PAGES) {
+        int result = flash_log_commit();
+        if (result != FLASH_LOG_OK) return result;
+    }
+
+    uint8_t *page = &log->staging[log->staged * FLASH_LOG_PAGE_SIZE];
+    flash_log_header_t header = {
+        .magic = FLASH_LOG_MAGIC,
+        .length = (uint16_t)length,
+        .seq = log->next_seq++,
+        .consumed = FLASH_LOG_PENDING,
+        .reserved = {0xFF, 0xFF, 0xFF},
+    };
+    header.crc = flash_log_crc(&header, data);
+
+    memset(page, 0xFF, FLASH_LOG_PAGE_SIZE);
+    memcpy(page, &header, sizeof(header));
+    memcpy(page + FLASH_LOG_HEADER_SIZE, data, length);
+    log->staged++;
+
+    if (log->staged == FLASH_LOG_STAGE_PAGES) {
+        flash_log_commit(); // Em caso de falha, a próxima chamada tenta de novo
+    }
+    return FLASH_LOG_OK;
+}
+
+// Grava as páginas ainda em RAM
+int flash_log_flush(void) {
+    if (!flash_log_state.initialized) {
+        return FLASH_LOG_ERROR_NOT_INITIALIZED;
+    }
+    return flash_log_commit();
+}
+
+uint32_t flash_log_pending(void) {
+    return flash_log_state.pending;
+}
+
+uint32_t flash_log_staged(void) {
+    return flash_log_state.staged;
+}
+
+uint32_t flash_log_overwritten(void) {
+    return flash_log_state.overwritten;
+}
+
+// Posiciona um cursor no registro pendente mais antigo
+void flash_log_cursor_begin(flash_log_cursor_t *cursor) {
+    cursor->page = flash_log_state.read_page;
+    cursor->remaining = flash_log_state.pending;
+    cursor->seq = 0;
+}
+
+// Lê o próximo registro pendente, ignorando páginas corrompidas
+int flash_log_read(flash_log_cursor_t *cursor, uint8_t *out, uint32_t *length) {
+    while (cursor->remaining > 0) {
+        const uint8_t *ptr = flash_log_page_ptr(cursor->page);
+        cursor->page = flash_log_next(cursor->page, 1);
+        cursor->remaining--;
+
+        if (flash_log_page_valid(ptr)) {
+            *length = ((const flash_log_header_t *)ptr)->length;
+            cursor->seq = ((const flash_log_header_t *)ptr)->seq;
+            memcpy(out, ptr + FLASH_LOG_HEADER_SIZE, *length);
+            return FLASH_LOG_OK;
+        }
+    }
+    return FLASH_LOG_ERROR_EMPTY;
+}
+
+// Marca os registros pendentes mais antigos como consumidos
+int flash_log_consume(uint32_t count) {
+    flash_log_state_t *log = &flash_log_state;
+
+    if (!log->initialized) {
+        return FLASH_LOG_ERROR_NOT_INITIALIZED;
+    }
+    if (count > log->pending) {
+        count = log->pending;
+    }
+
+    // Em blocos, para que cada pausa da flash tenha duração limitada
+    while (count > 0) {
+        flash_log_program_t program = {log->read_page, count < FLASH_LOG_MARK_BATCH ? count : FLASH_LOG_MARK_BATCH, NULL};
+        if (flash_safe_execute(flash_log_do_program, &program, FLASH_LOG_SAFE_TIMEOUT_MS) != PICO_OK) {
+            return FLASH_LOG_ERROR_FLASH;
+        }
+        log->read_page = flash_log_next(log->read_page, program.count);
+        log->pending -= program.count;
+        count -= program.count;
+    }
+    return FLASH_LOG_OK;
+}
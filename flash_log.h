@@ -0,0 +1,136 @@
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Códigos de retorno para as operações do log
+#define FLASH_LOG_OK 0                    // Operação bem-sucedida
+#define FLASH_LOG_ERROR_TOO_LARGE -1      // Registro maior que FLASH_LOG_PAGE_PAYLOAD
+#define FLASH_LOG_ERROR_FLASH -2          // flash_safe_execute() não conseguiu pausar o outro núcleo
+#define FLASH_LOG_ERROR_EMPTY -3          // Nenhum registro pendente
+#define FLASH_LOG_ERROR_NOT_INITIALIZED -4 // flash_log_init() não foi chamada ou falhou
+#define FLASH_LOG_ERROR_NO_SPACE -5       // Região do log sobrepõe o binário gravado na flash
+
+// Tamanho da região do log (setores de 4 KB); fica logo antes do último setor da flash
+#ifndef FLASH_LOG_SECTORS
+#define FLASH_LOG_SECTORS 64
+#endif
+
+// Registros reunidos em RAM antes de programar a flash (1..16). Cada gravação
+// pausa o outro núcleo; o que ainda está em RAM se perde num reset.
+#ifndef FLASH_LOG_STAGE_PAGES
+#define FLASH_LOG_STAGE_PAGES 4
+#endif
+
+// Formato das páginas
+#define FLASH_LOG_PAGE_SIZE 256           // Página de programação da flash
+#define FLASH_LOG_HEADER_SIZE 16          // Cabeçalho de cada página
+#define FLASH_LOG_PAGE_PAYLOAD (FLASH_LOG_PAGE_SIZE - FLASH_LOG_HEADER_SIZE) // Bytes úteis por página
+
+/**
+ * Posição de leitura sobre os registros pendentes.
+ *
+ * Ler não altera a flash: depois de enviar os registros, confirme-os com
+ * flash_log_consume(). Após uma queda do enlace, basta recomeçar a leitura.
+ */
+typedef struct {
+    uint32_t page;               // Próxima página a ler
+    uint32_t remaining;          // Páginas pendentes ainda não lidas por este cursor
+    uint32_t seq;                // Número de sequência do último registro lido
+} flash_log_cursor_t;
+
+/**
+ * Inicializa o log e recupera o estado gravado.
+ *
+ * O log ocupa FLASH_LOG_SECTORS setores no fim da flash (antes do último
+ * setor, reservado para configuração). Cada registro ocupa uma página de
+ * 256 bytes com número de sequência e CRC-32; páginas lidas são marcadas
+ * programando um único byte (0xFF -> 0x00), sem apagar o setor. A varredura
+ * encontra a página mais nova e a mais antiga ainda não lida, de modo que
+ * os registros sobrevivem a reinicializações.
+ *
+ * A escrita percorre a região em anel, e cada setor é apagado apenas quando
+ * a escrita volta a ele: o desgaste é distribuído igualmente. Quando o anel
+ * está cheio, os registros mais antigos não lidos são sobrescritos.
+ *
+ * Deve ser chamada pelo núcleo que fará as escritas, depois que o outro
+ * núcleo estiver executando flash_safe_execute_core_init().
+ *
+ * @return FLASH_LOG_OK ou FLASH_LOG_ERROR_NO_SPACE
+ */
+int flash_log_init(void);
+
+/**
+ * Acrescenta um registro ao log
+ *
+ * O registro é guardado em RAM e gravado junto com os seguintes quando
+ * FLASH_LOG_STAGE_PAGES páginas estiverem reunidas: as pausas de XIP nos
+ * dois núcleos ficam raras e previsíveis, e cada setor continua sendo
+ * apagado uma única vez. Use flash_log_flush() para gravar antes disso, por
+ * exemplo periodicamente, limitando os dados perdidos num reset.
+ *
+ * @param data Registro (normalmente um lote de telemetria)
+ * @param length Tamanho (1..FLASH_LOG_PAGE_PAYLOAD)
+ * @return FLASH_LOG_OK, FLASH_LOG_ERROR_TOO_LARGE, FLASH_LOG_ERROR_FLASH ou
+ *         FLASH_LOG_ERROR_NOT_INITIALIZED
+ */
+int flash_log_append(const uint8_t *data, uint32_t length);
+
+/**
+ * Grava na flash os registros ainda em RAM
+ *
+ * Chamada, por exemplo, antes de desligar ou quando a bateria está baixa.
+ *
+ * @return FLASH_LOG_OK, FLASH_LOG_ERROR_FLASH ou FLASH_LOG_ERROR_NOT_INITIALIZED
+ */
+int flash_log_flush(void);
+
+/**
+ * @return Registros gravados na flash e ainda não consumidos
+ */
+uint32_t flash_log_pending(void);
+
+/**
+ * @return Registros ainda em RAM, aguardando gravação
+ */
+uint32_t flash_log_staged(void);
+
+/**
+ * @return Registros não lidos perdidos por sobrescrita desde a inicialização
+ */
+uint32_t flash_log_overwritten(void);
+
+/**
+ * Posiciona um cursor no registro pendente mais antigo
+ *
+ * @param cursor Cursor
+ */
+void flash_log_cursor_begin(flash_log_cursor_t *cursor);
+
+/**
+ * Lê o próximo registro pendente
+ *
+ * O número de sequência da página (único e crescente no log, inclusive
+ * entre reinicializações) fica em cursor->seq e identifica o registro para
+ * o receptor.
+ *
+ * @param cursor Cursor obtido de flash_log_cursor_begin()
+ * @param out Destino (ao menos FLASH_LOG_PAGE_PAYLOAD bytes)
+ * @param length Tamanho do registro lido
+ * @return FLASH_LOG_OK ou FLASH_LOG_ERROR_EMPTY
+ */
+int flash_log_read(flash_log_cursor_t *cursor, uint8_t *out, uint32_t *length);
+
+/**
+ * Marca os registros pendentes mais antigos como consumidos
+ *
+ * As marcações são programadas em blocos de até 16 páginas por pausa da
+ * flash, para limitar o tempo em que o outro núcleo fica parado.
+ *
+ * @param count Registros enviados com sucesso (limitado a flash_log_pending())
+ * @return FLASH_LOG_OK, FLASH_LOG_ERROR_FLASH ou FLASH_LOG_ERROR_NOT_INITIALIZED
+ */
+int flash_log_consume(uint32_t count);
+
+#endif
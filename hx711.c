@@ -1,160 +1,543 @@
-#include "dht22.h"
+#include "hx711.h"
 #include "pico/stdlib.h"
 #include "hardware/gpio.h"
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hx711.pio.h"
+#include "metrics.h"
+#include "trace.h"
 
-// Constantes de temporização para o protocolo do DHT22
-#define DHT22_START_SIGNAL_DELAY 18000 // 18ms em microssegundos
-#define DHT22_RESPONSE_WAIT_TIMEOUT 200 // Timeout para resposta em microssegundos
-#define DHT22_BIT_THRESHOLD 50         // Limite para distinguir entre bit 0 e bit 1 (em μs)
-#define DHT22_MIN_INTERVAL_MS 2000     // Intervalo mínimo entre leituras (2 segundos)
+// Constantes do protocolo do HX711
+#define HX711_READ_TIMEOUT_US 150000   // Maior que um período de conversão a 10 SPS (100ms)
+#define HX711_RX_FIFO_DEPTH 4          // Profundidade da RX FIFO (sem junção)
+#define HX711_POWER_UP_DISCARD 4       // Conversões de acomodação após o reset (HX711_POWER_UP_MS a 10 SPS)
+#define HX711_STREAM_TRANSFER_COUNT 0xFFFFFFFFu // Transferências por disparo do DMA (~620 dias a 80 SPS)
+#define HX711_STREAM_MAX_BYTES 32768   // Maior anel suportado pelo DMA (2^15 bytes)
+#define HX711_PIO_IRQ_INDEX 1          // Linha de interrupção do PIO usada para "dado pronto"
 
-// Estado do driver DHT22
+// Estado do driver HX711
 typedef struct {
-    uint32_t last_read_time_ms;  // Timestamp da última leitura
-    uint32_t pin;                // Pino GPIO usado para comunicação
+    uint32_t gpio_dt;            // Pino DOUT
+    uint32_t gpio_sck;           // Pino SCK
     bool initialized;            // Indicador de inicialização
-} dht22_state_t;
+    PIO pio;                     // Bloco PIO
+    uint sm;                     // Máquina de estados reservada
+    uint offset;                 // Endereço do programa na memória do PIO
+    uint irq_num;                // Interrupção do PIO (linha HX711_PIO_IRQ_INDEX)
+    bool streaming;              // Modo contínuo (DMA) ativo
+    int dma_chan;                // Canal DMA do modo contínuo
+    int32_t *stream_buffer;      // Anel de amostras fornecido pelo chamador
+    uint32_t stream_capacity;    // Capacidade do anel (potência de 2)
+    uint32_t stream_base;        // Amostras produzidas em disparos anteriores do DMA
+    uint32_t stream_consumed;    // Total de amostras já entregues ao chamador
+    uint32_t stream_overruns;    // Amostras sobrescritas antes de serem lidas
+    uint32_t stream_settle;      // Índice da primeira amostra do anel após a acomodação
+    uint32_t settle_remaining;   // Conversões a descartar fora do modo contínuo
+    hx711_gain_t gain;           // Canal e ganho selecionados
+    hx711_rate_t rate;           // Taxa selecionada
+    bool has_rate_pin;           // Pino RATE controlado pelo driver
+    uint32_t gpio_rate;          // Pino RATE
+    bool powered_down;           // SCK mantido em HIGH por hx711_power_down()
+} hx711_state_t;
 
 // Estado global do driver
-static dht22_state_t dht22_state = {0, 0, false};
-
-// Função auxiliar para esperar até o pino mudar de estado
-static inline int wait_for_pin_state(uint32_t pin, bool state, uint32_t timeout_us) {
-    uint32_t start = time_us_32();
-    while (gpio_get(pin) != state) {
-        if ((time_us_32() - start) > timeout_us) {
-            return -1; // Timeout
+static hx711_state_t hx711_state = {.dma_chan = -1}; // Sem canal DMA fora do modo contínuo
+
+// Fator de escala e tara usados em todas as conversões
+float scale_factor = 1.0f;
+int32_t tare_offset = 0;
+
+// Coeficientes equivalentes a scale_factor = 1.0 e tara zero
+hx711_coeffs_t hx711_coeffs = {1000 << HX711_Q_FRAC_BITS, 1 << (HX711_Q_FRAC_BITS - 1), INT32_MIN, INT32_MAX};
+
+// Estende o sinal da leitura de 24 bits em complemento de dois
+static inline int32_t hx711_sign_extend(uint32_t raw) {
+    return (int32_t)(raw << 8) >> 8;
+}
+
+// Fonte "RX FIFO não vazia" da máquina de estados do HX711
+static inline pio_interrupt_source_t hx711_ready_source(void) {
+    return (pio_interrupt_source_t)(pis_sm0_rx_fifo_not_empty + hx711_state.sm);
+}
+
+// Conversão pronta: desarma a fonte (o nível permanece até a FIFO ser lida) e
+// acorda quem espera em WFE. O tratador é compartilhado com outros usuários do PIO.
+static void hx711_ready_irq_handler(void) {
+    uint32_t mask = 1u << (pis_sm0_rx_fifo_not_empty + hx711_state.sm);
+    if ((hx711_state.pio->ints1 & mask) == 0) {
+        return;
+    }
+    pio_set_irqn_source_enabled(hx711_state.pio, HX711_PIO_IRQ_INDEX, hx711_ready_source(), false);
+    __sev();
+}
+
+// Reserva uma máquina de estados e carrega o programa em pio0 ou pio1
+static int hx711_claim_pio(void) {
+    PIO blocks[2] = {pio0, pio1};
+
+    for (int i = 0; i < 2; i++) {
+        if (!pio_can_add_program(blocks[i], &hx711_program)) {
+            continue;
         }
+        int claimed = pio_claim_unused_sm(blocks[i], false);
+        if (claimed < 0) {
+            continue;
+        }
+        hx711_state.pio = blocks[i];
+        hx711_state.sm = (uint)claimed;
+        hx711_state.offset = pio_add_program(blocks[i], &hx711_program);
+        return HX711_OK;
     }
-    return 0; // Sucesso
+    return HX711_ERROR_NO_RESOURCES;
 }
 
-// Inicializa o driver DHT22
-int dht22_init(uint32_t pin) {
-    // Configura o pino GPIO
-    gpio_init(pin);
-    gpio_set_pulls(pin, true, false); // Habilita pull-up
-    
-    // Inicializa o estado do driver
-    dht22_state.pin = pin;
-    dht22_state.last_read_time_ms = 0;
-    dht22_state.initialized = true;
-    
-    return DHT22_OK;
+// Inicializa o driver HX711
+int hx711_init(uint32_t gpio_dt, uint32_t gpio_sck) {
+    if (!hx711_state.initialized) {
+        int result = hx711_claim_pio();
+        if (result != HX711_OK) return result;
+
+        hx711_state.irq_num = pio_get_irq_num(hx711_state.pio, HX711_PIO_IRQ_INDEX);
+        irq_add_shared_handler(hx711_state.irq_num, hx711_ready_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(hx711_state.irq_num, true);
+    } else {
+        pio_sm_set_enabled(hx711_state.pio, hx711_state.sm, false);
+    }
+
+    // O programa começa com SCK em LOW: um HX711 desligado reinicia
+    if (hx711_state.powered_down) {
+        hx711_state.settle_remaining = HX711_POWER_UP_DISCARD;
+        hx711_state.powered_down = false;
+    }
+    hx711_program_init(hx711_state.pio, hx711_state.sm, hx711_state.offset, gpio_dt, gpio_sck);
+
+    // Ganho da próxima conversão (canal A, 128 até a primeira hx711_set_gain())
+    pio_sm_put(hx711_state.pio, hx711_state.sm, (uint32_t)hx711_state.gain);
+    pio_sm_set_enabled(hx711_state.pio, hx711_state.sm, true);
+
+    hx711_state.gpio_dt = gpio_dt;
+    hx711_state.gpio_sck = gpio_sck;
+    hx711_state.initialized = true;
+
+    return HX711_OK;
 }
 
-// Envia o sinal de inicialização para o sensor
-static int dht22_send_start_signal(uint32_t pin) {
-    // Configura o pino como saída
-    gpio_set_dir(pin, GPIO_OUT);
-    
-    // Envia o sinal de início (LOW por 18ms, depois HIGH por 30us)
-    gpio_put(pin, 0);
-    sleep_us(DHT22_START_SIGNAL_DELAY);
-    gpio_put(pin, 1);
-    sleep_us(30);
-    
-    // Configura o pino como entrada para receber a resposta
-    gpio_set_dir(pin, GPIO_IN);
-    
-    return DHT22_OK;
+// Total de amostras escritas no anel pelo DMA desde hx711_stream_start()
+static uint32_t hx711_stream_produced(void) {
+    uint32_t remaining = dma_channel_hw_addr(hx711_state.dma_chan)->transfer_count;
+    return hx711_state.stream_base + (HX711_STREAM_TRANSFER_COUNT - remaining);
 }
 
-// Aguarda e verifica a resposta inicial do sensor
-static int dht22_wait_for_response(uint32_t pin) {
-    // Aguarda a sequência de resposta do sensor
-    if (wait_for_pin_state(pin, 0, DHT22_RESPONSE_WAIT_TIMEOUT) != 0) return DHT22_ERROR_TIMEOUT;
-    if (wait_for_pin_state(pin, 1, DHT22_RESPONSE_WAIT_TIMEOUT) != 0) return DHT22_ERROR_TIMEOUT;
-    if (wait_for_pin_state(pin, 0, DHT22_RESPONSE_WAIT_TIMEOUT) != 0) return DHT22_ERROR_TIMEOUT;
-    
-    return DHT22_OK;
-}
-
-// Lê os 40 bits de dados do sensor
-static int dht22_read_data(uint32_t pin, uint8_t *data) {
-    // Lê os 40 bits (5 bytes) de dados
-    for (int i = 0; i < 40; i++) {
-        // Aguarda o início do pulso (LOW para HIGH)
-        if (wait_for_pin_state(pin, 1, DHT22_RESPONSE_WAIT_TIMEOUT) != 0) return DHT22_ERROR_TIMEOUT;
-        
-        // Mede a duração do pulso HIGH
-        uint32_t pulse_start = time_us_32();
-        if (wait_for_pin_state(pin, 0, DHT22_RESPONSE_WAIT_TIMEOUT) != 0) return DHT22_ERROR_TIMEOUT;
-        uint32_t pulse_length = time_us_32() - pulse_start;
-        
-        // Determina o valor do bit com base na duração do pulso
-        if (pulse_length > DHT22_BIT_THRESHOLD) {
-            data[i / 8] |= (1 << (7 - (i % 8))); // Define bit 1
+// Descarta as próximas HX711_SETTLE_DISCARD conversões
+static void hx711_begin_settle(void) {
+    if (hx711_state.streaming) {
+        hx711_state.stream_settle = hx711_stream_produced() + HX711_SETTLE_DISCARD;
+    } else {
+        hx711_state.settle_remaining = HX711_SETTLE_DISCARD;
+    }
+}
+
+// Lê a amostra mais recente do anel (modo contínuo), aguardando se ainda não
+// houver nenhuma fora da acomodação
+static int32_t hx711_stream_latest(void) {
+    PIO pio = hx711_state.pio;
+    absolute_time_t deadline = make_timeout_time_us(HX711_READ_TIMEOUT_US * (1 + HX711_SETTLE_DISCARD));
+    uint32_t produced;
+
+    // Como em hx711_read(), o núcleo dorme em WFE: cada conversão aciona a
+    // interrupção de RX FIFO não vazia antes de o DMA esvaziar a FIFO, e a
+    // entrada na interrupção basta para acordá-lo
+    while ((produced = hx711_stream_produced()) == 0 || (int32_t)(produced - hx711_state.stream_settle) <= 0) {
+        if (time_reached(deadline)) {
+            pio_set_irqn_source_enabled(pio, HX711_PIO_IRQ_INDEX, hx711_ready_source(), false);
+            metrics_add(METRICS_HX711_ERRORS, 1);
+            return HX711_READ_ERROR;
         }
-        // Para bit 0, não precisa fazer nada (já inicializamos com zeros)
+        pio_set_irqn_source_enabled(pio, HX711_PIO_IRQ_INDEX, hx711_ready_source(), true);
+        best_effort_wfe_or_timeout(deadline);
+    }
+    pio_set_irqn_source_enabled(pio, HX711_PIO_IRQ_INDEX, hx711_ready_source(), false);
+    uint32_t index = (produced - 1) & (hx711_state.stream_capacity - 1);
+    return hx711_sign_extend((uint32_t)hx711_state.stream_buffer[index]);
+}
+
+// Lê a leitura bruta mais recente do HX711
+int32_t hx711_read(uint32_t gpio_dt, uint32_t gpio_sck) {
+    PIO pio;
+    uint sm;
+
+    if (!hx711_state.initialized || hx711_state.gpio_dt != gpio_dt || hx711_state.gpio_sck != gpio_sck) {
+        if (hx711_state.streaming) return HX711_READ_ERROR;
+        if (hx711_init(gpio_dt, gpio_sck) != HX711_OK) return HX711_READ_ERROR;
+    }
+    if (hx711_state.powered_down) {
+        return HX711_READ_ERROR;
     }
     
-    return DHT22_OK;
+    // No modo contínuo a RX FIFO pertence ao DMA: a leitura vem do anel
+    if (hx711_state.streaming) {
+        return hx711_stream_latest();
+    }
+    pio = hx711_state.pio;
+    sm = hx711_state.sm;
+    TRACE(TRACE_HX711_READ_BEGIN, 0);
+    metrics_add(METRICS_HX711_READS, 1);
+
+    // Com a FIFO cheia, leituras mais novas podem ter sido descartadas pelo PIO:
+    // esvazia a RX FIFO (a TX guarda um ganho pendente) e aguarda uma conversão nova
+    if (pio_sm_get_rx_fifo_level(pio, sm) >= HX711_RX_FIFO_DEPTH) {
+        while (!pio_sm_is_rx_fifo_empty(pio, sm)) {
+            (void)pio_sm_get(pio, sm);
+            if (hx711_state.settle_remaining > 0) hx711_state.settle_remaining--;
+        }
+    }
+
+    // O PIO espera o DOUT descer e desloca os 24 bits sozinho; até lá o núcleo
+    // dorme em WFE e é acordado pela interrupção de RX FIFO não vazia
+    absolute_time_t deadline = make_timeout_time_us(HX711_READ_TIMEOUT_US * (1 + hx711_state.settle_remaining));
+    uint32_t raw = 0;
+    bool have = false;
+    while (!have) {
+        while (pio_sm_is_rx_fifo_empty(pio, sm)) {
+            if (time_reached(deadline)) {
+                pio_set_irqn_source_enabled(pio, HX711_PIO_IRQ_INDEX, hx711_ready_source(), false);
+                TRACE(TRACE_HX711_READ_END, 1);
+                metrics_add(METRICS_HX711_ERRORS, 1);
+                return HX711_READ_ERROR;
+            }
+            pio_set_irqn_source_enabled(pio, HX711_PIO_IRQ_INDEX, hx711_ready_source(), true);
+            best_effort_wfe_or_timeout(deadline);
+        }
+        TRACE(TRACE_HX711_READ_READY, pio_sm_get_rx_fifo_level(pio, sm));
+
+        // Mantém apenas a conversão mais recente, ignorando as de acomodação
+        while (!pio_sm_is_rx_fifo_empty(pio, sm)) {
+            uint32_t value = pio_sm_get(pio, sm);
+            if (hx711_state.settle_remaining > 0) {
+                hx711_state.settle_remaining--;
+            } else {
+                raw = value;
+                have = true;
+            }
+        }
+    }
+    TRACE(TRACE_HX711_READ_END, 0);
+
+    return hx711_sign_extend(raw);
 }
 
-// Verifica o checksum dos dados recebidos
-static int dht22_verify_checksum(const uint8_t *data) {
-    uint8_t checksum = data[0] + data[1] + data[2] + data[3];
-    if (checksum != data[4]) {
-        return DHT22_ERROR_CHECKSUM;
+// Inicia o modo contínuo: o DMA drena a RX FIFO para o anel do chamador
+int hx711_stream_start(int32_t *buffer, uint32_t capacity) {
+    uint32_t bytes = capacity * sizeof(int32_t);
+    uint ring_bits = 0;
+
+    if (!hx711_state.initialized) {
+        return HX711_ERROR_NOT_INITIALIZED;
+    }
+    if (hx711_state.powered_down) {
+        return HX711_ERROR_POWERED_DOWN;
+    }
+    if (hx711_state.streaming) {
+        hx711_stream_stop();
+    }
+
+    // O anel de escrita do DMA exige tamanho potência de 2 e alinhamento ao tamanho
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0 || bytes > HX711_STREAM_MAX_BYTES ||
+        ((uintptr_t)buffer & (bytes - 1)) != 0) {
+        return HX711_ERROR_INVALID_BUFFER;
+    }
+    while ((1u << ring_bits) < bytes) {
+        ring_bits++;
+    }
+
+    int chan = dma_claim_unused_channel(false);
+    if (chan < 0) {
+        return HX711_ERROR_NO_RESOURCES;
     }
-    return DHT22_OK;
+
+    hx711_state.dma_chan = chan;
+    hx711_state.stream_buffer = buffer;
+    hx711_state.stream_capacity = capacity;
+    hx711_state.stream_base = 0;
+    hx711_state.stream_consumed = 0;
+    hx711_state.stream_overruns = 0;
+    hx711_state.stream_settle = hx711_state.settle_remaining; // Acomodação pendente continua no anel
+    hx711_state.settle_remaining = 0;
+
+    // Descarta conversões antigas: o anel começa com amostras novas
+    pio_sm_clear_fifos(hx711_state.pio, hx711_state.sm);
+
+    dma_channel_config c = dma_channel_get_default_config(chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_ring(&c, true, ring_bits);
+    channel_config_set_dreq(&c, pio_get_dreq(hx711_state.pio, hx711_state.sm, false));
+    dma_channel_configure(chan, &c, buffer, &hx711_state.pio->rxf[hx711_state.sm],
+                          HX711_STREAM_TRANSFER_COUNT, true);
+
+    hx711_state.streaming = true;
+    return HX711_OK;
 }
 
-// Converte os dados brutos em valores de temperatura e umidade
-static int dht22_convert_data(const uint8_t *data, float *temperature, float *humidity) {
-    // Calcula umidade
-    *humidity = ((data[0] << 8) | data[1]) * 0.1;
-    
-    // Calcula temperatura com sinal
-    *temperature = ((data[2] & 0x7F) << 8 | data[3]) * 0.1;
-    if (data[2] & 0x80) {
-        *temperature *= -1; // Temperatura negativa
+// Encerra o modo contínuo e libera o canal DMA
+void hx711_stream_stop(void) {
+    if (!hx711_state.streaming) {
+        return;
     }
-    
-    // Valida os valores obtidos
-    if (*humidity < 0.0 || *humidity > 100.0 || *temperature < -40.0 || *temperature > 80.0) {
-        return DHT22_ERROR_INVALID_DATA;
+    uint32_t produced = hx711_stream_produced();
+    if ((int32_t)(hx711_state.stream_settle - produced) > 0) {
+        hx711_state.settle_remaining = hx711_state.stream_settle - produced;
     }
-    
-    return DHT22_OK;
+    dma_channel_abort(hx711_state.dma_chan);
+    dma_channel_unclaim(hx711_state.dma_chan);
+    hx711_state.dma_chan = -1;
+    hx711_state.streaming = false;
 }
 
-// Função principal para ler temperatura e umidade do DHT22
-int dht22_read(float *temperature, float *humidity) {
-    int result;
-    uint8_t data[5] = {0};
-    
-    // Verifica se o driver foi inicializado
-    if (!dht22_state.initialized) {
-        return DHT22_ERROR_NOT_INITIALIZED;
+// Número de amostras disponíveis no anel (limitado à capacidade)
+uint32_t hx711_stream_available(void) {
+    if (!hx711_state.streaming) {
+        return 0;
     }
-    
-    // Verifica o intervalo mínimo entre leituras
-    uint32_t current_time = to_ms_since_boot(get_absolute_time());
-    if ((current_time - dht22_state.last_read_time_ms) < DHT22_MIN_INTERVAL_MS && dht22_state.last_read_time_ms != 0) {
-        sleep_ms(DHT22_MIN_INTERVAL_MS - (current_time - dht22_state.last_read_time_ms));
+    uint32_t available = hx711_stream_produced() - hx711_state.stream_consumed;
+    return available < hx711_state.stream_capacity ? available : hx711_state.stream_capacity;
+}
+
+// Copia um lote de amostras do anel, já com o sinal estendido
+uint32_t hx711_stream_read(int32_t *out, uint32_t max_samples) {
+    if (!hx711_state.streaming) {
+        return 0;
     }
+
+    // Rearma o DMA quando o contador de transferências se esgota, sem mover o anel
+    if (!dma_channel_is_busy(hx711_state.dma_chan)) {
+        hx711_state.stream_base += HX711_STREAM_TRANSFER_COUNT;
+        dma_channel_set_trans_count(hx711_state.dma_chan, HX711_STREAM_TRANSFER_COUNT, true);
+    }
+
+    uint32_t produced = hx711_stream_produced();
+    uint32_t available = produced - hx711_state.stream_consumed;
+
+    // O DMA deu a volta no anel: as amostras mais antigas foram sobrescritas.
+    // Mantém uma posição de folga para a escrita em andamento.
+    if (available >= hx711_state.stream_capacity) {
+        uint32_t lost = available - (hx711_state.stream_capacity - 1);
+        hx711_state.stream_consumed += lost;
+        hx711_state.stream_overruns += lost;
+        metrics_add(METRICS_HX711_OVERRUNS, lost);
+        available -= lost;
+    }
+
+    // Conversões de acomodação após trocar ganho ou taxa
+    if ((int32_t)(hx711_state.stream_settle - hx711_state.stream_consumed) > 0) {
+        uint32_t skip = hx711_state.stream_settle - hx711_state.stream_consumed;
+        if (skip > available) skip = available;
+        hx711_state.stream_consumed += skip;
+        available -= skip;
+    }
+
+    uint32_t count = available < max_samples ? available : max_samples;
+    uint32_t mask = hx711_state.stream_capacity - 1;
+    const int32_t *ring = hx711_state.stream_buffer;
+    uint32_t index = hx711_state.stream_consumed;
+
+    for (uint32_t i = 0; i < count; i++) {
+        out[i] = hx711_sign_extend((uint32_t)ring[(index + i) & mask]);
+    }
+    hx711_state.stream_consumed += count;
+
+    return count;
+}
+
+// Seleciona canal e ganho das próximas conversões
+int hx711_set_gain(hx711_gain_t gain) {
+    if (!hx711_state.initialized) {
+        return HX711_ERROR_NOT_INITIALIZED;
+    }
+    if (gain != HX711_GAIN_A128 && gain != HX711_GAIN_B32 && gain != HX711_GAIN_A64) {
+        return HX711_ERROR_INVALID_PARAM;
+    }
+
+    // Em power-down a máquina de estados está parada: hx711_power_up() envia o ganho
+    if (hx711_state.powered_down) {
+        hx711_state.gain = gain;
+        return HX711_OK;
+    }
+
+    // Fora do modo contínuo, as conversões antigas da RX FIFO também saem;
+    // o PIO passa a usar o novo valor no próximo "pull noblock"
+    if (!hx711_state.streaming) {
+        pio_sm_clear_fifos(hx711_state.pio, hx711_state.sm);
+    }
+    if (pio_sm_is_tx_fifo_full(hx711_state.pio, hx711_state.sm)) {
+        return HX711_ERROR_BUSY; // SM à espera do DOUT: pio_sm_put_blocking() travaria o chamador
+    }
+    pio_sm_put(hx711_state.pio, hx711_state.sm, (uint32_t)gain);
+    hx711_state.gain = gain;
+    hx711_begin_settle();
+    return HX711_OK;
+}
+
+hx711_gain_t hx711_get_gain(void) {
+    return hx711_state.gain;
+}
+
+// Associa um pino GPIO ao RATE do HX711
+void hx711_set_rate_pin(uint32_t gpio_rate) {
+    gpio_init(gpio_rate);
+    gpio_put(gpio_rate, hx711_state.rate == HX711_RATE_80SPS);
+    gpio_set_dir(gpio_rate, GPIO_OUT);
+    hx711_state.gpio_rate = gpio_rate;
+    hx711_state.has_rate_pin = true;
+}
+
+// Alterna a taxa de conversão
+int hx711_set_rate(hx711_rate_t rate) {
+    if (!hx711_state.has_rate_pin) {
+        return HX711_ERROR_NO_RATE_PIN;
+    }
+    if (rate != HX711_RATE_10SPS && rate != HX711_RATE_80SPS) {
+        return HX711_ERROR_INVALID_PARAM;
+    }
+    if (rate == hx711_state.rate) {
+        return HX711_OK;
+    }
+
+    gpio_put(hx711_state.gpio_rate, rate == HX711_RATE_80SPS);
+    hx711_state.rate = rate;
+    if (hx711_state.initialized) {
+        hx711_begin_settle();
+    }
+    return HX711_OK;
+}
+
+hx711_rate_t hx711_get_rate(void) {
+    return hx711_state.rate;
+}
+
+// Coloca o HX711 em power-down
+int hx711_power_down(void) {
+    PIO pio = hx711_state.pio;
+    uint sm = hx711_state.sm;
+
+    if (!hx711_state.initialized) {
+        return HX711_ERROR_NOT_INITIALIZED;
+    }
+    if (hx711_state.streaming) {
+        return HX711_ERROR_STREAMING;
+    }
+    if (hx711_state.powered_down) {
+        return HX711_OK;
+    }
+
+    // Uma conversão interrompida no meio é perdida: o HX711 reinicia ao religar
+    pio_sm_set_enabled(pio, sm, false);
+    pio_set_irqn_source_enabled(pio, HX711_PIO_IRQ_INDEX, hx711_ready_source(), false);
+    pio_sm_set_pins_with_mask(pio, sm, 1u << hx711_state.gpio_sck, 1u << hx711_state.gpio_sck);
+    hx711_state.powered_down = true;
+    return HX711_OK;
+}
+
+// Religa o HX711 e retoma as conversões
+int hx711_power_up(void) {
+    PIO pio = hx711_state.pio;
+    uint sm = hx711_state.sm;
+
+    if (!hx711_state.initialized) {
+        return HX711_ERROR_NOT_INITIALIZED;
+    }
+    if (!hx711_state.powered_down) {
+        return HX711_OK;
+    }
+
+    // SCK em LOW reinicia o HX711; o programa recomeça do início com o ganho atual
+    pio_sm_set_pins_with_mask(pio, sm, 0, 1u << hx711_state.gpio_sck);
+    pio_sm_clear_fifos(pio, sm);
+    pio_sm_restart(pio, sm);
+    pio_sm_exec(pio, sm, pio_encode_jmp(hx711_state.offset));
+    pio_sm_put(pio, sm, (uint32_t)hx711_state.gain);
+    hx711_state.settle_remaining = HX711_POWER_UP_DISCARD;
+    hx711_state.powered_down = false;
+    pio_sm_set_enabled(pio, sm, true);
+    return HX711_OK;
+}
+
+bool hx711_is_powered_down(void) {
+    return hx711_state.powered_down;
+}
+
+// Total de amostras perdidas por estouro do anel
+uint32_t hx711_stream_overruns(void) {
+    return hx711_state.stream_overruns;
+}
+
+// Pré-calcula o multiplicador e o deslocamento em ponto fixo (mantém os limites atuais)
+void hx711_compute_coeffs(hx711_coeffs_t *coeffs, int32_t tare, float scale) {
+    float scaled = scale * 1000.0f * (float)(1 << HX711_Q_FRAC_BITS);
     
-    // Envia o sinal de início
-    result = dht22_send_start_signal(dht22_state.pin);
-    if (result != DHT22_OK) return result;
-    
-    // Aguarda a resposta do sensor
-    result = dht22_wait_for_response(dht22_state.pin);
-    if (result != DHT22_OK) return result;
-    
-    // Lê os dados
-    result = dht22_read_data(dht22_state.pin, data);
-    if (result != DHT22_OK) return result;
-    
-    // Atualiza o timestamp da última leitura
-    dht22_state.last_read_time_ms = to_ms_since_boot(get_absolute_time());
-    
-    // Verifica o checksum
-    result = dht22_verify_checksum(data);
-    if (result != DHT22_OK) return result;
+    // Satura em vez de transbordar se a escala não couber no formato escolhido
+    if (scaled >= (float)INT32_MAX) {
+        coeffs->scale_q = INT32_MAX;
+    } else if (scaled <= (float)INT32_MIN) {
+        coeffs->scale_q = INT32_MIN;
+    } else {
+        coeffs->scale_q = (int32_t)(scaled + (scaled >= 0.0f ? 0.5f : -0.5f));
+    }
+    coeffs->bias_q = -(int64_t)tare * coeffs->scale_q + (1 << (HX711_Q_FRAC_BITS - 1));
+}
+
+// Converte a leitura bruta em peso (ponto fixo)
+int32_t calculate_weight_mg(int32_t reading) {
+    return hx711_apply_coeffs(&hx711_coeffs, reading);
+}
+
+// Converte um lote de leituras brutas em peso
+void hx711_convert_batch(const int32_t *raw, int32_t *out_mg, size_t n) {
+    // Cópia local: os coeficientes ficam em registradores durante o lote
+    const hx711_coeffs_t coeffs = hx711_coeffs;
+    size_t i = 0;
     
-    // Converte e valida os dados
-    return dht22_convert_data(data, temperature, humidity);
-}
\ No newline at end of file
+    for (; i + 4 <= n; i += 4) {
+        int32_t r0 = raw[i];
+        int32_t r1 = raw[i + 1];
+        int32_t r2 = raw[i + 2];
+        int32_t r3 = raw[i + 3];
+        out_mg[i] = hx711_apply_coeffs(&coeffs, r0);
+        out_mg[i + 1] = hx711_apply_coeffs(&coeffs, r1);
+        out_mg[i + 2] = hx711_apply_coeffs(&coeffs, r2);
+        out_mg[i + 3] = hx711_apply_coeffs(&coeffs, r3);
+    }
+    for (; i < n; i++) {
+        out_mg[i] = hx711_apply_coeffs(&coeffs, raw[i]);
+    }
+}
+
+// Define a faixa de saturação das conversões
+void hx711_set_limits(int32_t min_mg, int32_t max_mg) {
+    hx711_coeffs.min_mg = min_mg;
+    hx711_coeffs.max_mg = max_mg;
+}
+
+// Converte a leitura bruta em peso
+float calculate_weight(int32_t reading) {
+    return (float)calculate_weight_mg(reading) * 0.001f;
+}
+
+// Define a tara
+void tare_hx711(int32_t zero_reading) {
+    tare_offset = zero_reading;
+    hx711_compute_coeffs(&hx711_coeffs, tare_offset, scale_factor);
+}
+
+// Calcula o fator de escala a partir de um peso conhecido
+void calibrate_hx711(int32_t known_weight_reading, float actual_weight) {
+    int32_t delta = known_weight_reading - tare_offset;
+    if (delta == 0) {
+        return; // Leitura igual à tara: não há como calcular a escala
+    }
+    scale_factor = actual_weight / (float)delta;
+    hx711_compute_coeffs(&hx711_coeffs, tare_offset, scale_factor);
+}
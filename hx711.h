@@ -1,34 +1,320 @@
 #ifndef HX711_H
 #define HX711_H
 
+#include <stdbool.h>
 #include <stdint.h>
+#include <stddef.h>
+
+// Códigos de retorno para as operações do driver HX711
+#define HX711_OK 0                        // Operação bem-sucedida
+#define HX711_ERROR_NO_RESOURCES -1       // Sem máquina de estados PIO ou canal DMA livre
+#define HX711_ERROR_NOT_INITIALIZED -2    // Driver não foi inicializado
+#define HX711_ERROR_INVALID_BUFFER -3     // Anel sem tamanho potência de 2 ou desalinhado
+#define HX711_ERROR_NO_RATE_PIN -4        // hx711_set_rate() sem pino RATE configurado
+#define HX711_ERROR_INVALID_PARAM -5      // Ganho ou taxa fora das opções do HX711
+#define HX711_ERROR_POWERED_DOWN -6       // HX711 desligado por hx711_power_down()
+#define HX711_ERROR_STREAMING -7          // Operação não permitida no modo contínuo
+#define HX711_ERROR_BUSY -8               // TX FIFO do PIO cheia: ganhos anteriores ainda não aplicados
+
+// Valor retornado por hx711_read() quando nenhuma conversão chega a tempo.
+// Fica fora da faixa de 24 bits do conversor e nunca é uma leitura válida.
+#define HX711_READ_ERROR INT32_MIN
+
+// Declara um anel de amostras para o modo contínuo. O DMA exige que a
+// capacidade seja potência de 2 (até 8192 amostras) e que o buffer esteja
+// alinhado ao seu tamanho em bytes.
+#define HX711_STREAM_BUFFER(name, capacity) \
+    int32_t name[capacity] __attribute__((aligned((capacity) * sizeof(int32_t))))
+
+// Bits fracionários do caminho de conversão em ponto fixo (Q16.16 por padrão).
+// O fator de escala em mg por contagem, deslocado por esses bits, precisa
+// caber em 32 bits: com 16 bits, até ~32 g por contagem.
+#ifndef HX711_Q_FRAC_BITS
+#define HX711_Q_FRAC_BITS 16
+#endif
+
+// Canal e ganho da próxima conversão (valor = pulsos extras de SCK - 1)
+typedef enum {
+    HX711_GAIN_A128 = 0,         // Canal A, ganho 128 (padrão após o reset)
+    HX711_GAIN_B32 = 1,          // Canal B, ganho 32
+    HX711_GAIN_A64 = 2           // Canal A, ganho 64
+} hx711_gain_t;
+
+// Taxa de conversão selecionada pelo pino RATE
+typedef enum {
+    HX711_RATE_10SPS,            // RATE em LOW: menos ruído, 100 ms por conversão
+    HX711_RATE_80SPS             // RATE em HIGH: 12,5 ms por conversão
+} hx711_rate_t;
+
+// Conversões descartadas após trocar ganho ou taxa: as duas já em andamento
+// no pipeline do PIO e as 4 de acomodação do filtro do HX711
+#define HX711_SETTLE_DISCARD 6
+
+// Acomodação do HX711 após sair do power-down, a 10 SPS (50 ms a 80 SPS)
+#define HX711_POWER_UP_MS 400
+
+// Coeficientes da conversão em ponto fixo, pré-calculados na calibração:
+// peso_mg = (leitura * scale_q + bias_q) >> HX711_Q_FRAC_BITS
+typedef struct {
+    int32_t scale_q;             // Milésimos de unidade (mg) por contagem, em ponto fixo
+    int64_t bias_q;              // -tara * scale_q, mais meio LSB para arredondamento
+    int32_t min_mg;              // Limite inferior do peso convertido
+    int32_t max_mg;              // Limite superior do peso convertido
+} hx711_coeffs_t;
 
 // Variável global para o fator de escala usado em todas as conversões
 extern float scale_factor;
 
+// Variável global com a leitura bruta correspondente a peso zero (tara)
+extern int32_t tare_offset;
+
+// Coeficientes em ponto fixo derivados de scale_factor e tare_offset
+extern hx711_coeffs_t hx711_coeffs;
+
+/**
+ * Inicializa o driver HX711 nos pinos especificados
+ *
+ * Reserva uma máquina de estados PIO (pio0 ou pio1) que gera o SCK e desloca
+ * o DOUT em hardware. A partir daí as conversões chegam continuamente na RX
+ * FIFO, sem bit-banging pela CPU. Também instala, no núcleo que chama, o
+ * tratador compartilhado da linha 1 de interrupção do PIO usado por
+ * hx711_read(). Chamar novamente com outros pinos reconfigura a mesma
+ * máquina de estados.
+ *
+ * @param gpio_dt Pino de dados conectado ao DOUT do HX711
+ * @param gpio_sck Pino de clock conectado ao SCK do HX711
+ * @return HX711_OK em caso de sucesso, HX711_ERROR_NO_RESOURCES se não houver PIO livre
+ */
+int hx711_init(uint32_t gpio_dt, uint32_t gpio_sck);
+
 /**
  * Realiza a leitura dos dados brutos do sensor HX711
- * 
+ *
+ * Inicializa o driver automaticamente se necessário. Retorna a conversão mais
+ * recente já recebida pelo PIO ou, se não houver uma, aguarda a próxima com o
+ * núcleo dormindo (WFE): a interrupção de RX FIFO não vazia do PIO acorda o
+ * núcleo assim que os 24 bits são deslocados, sem espera ocupada pelo DOUT.
+ * A latência fica limitada ao período de conversão mais a interrupção.
+ *
  * @param gpio_dt Pino de dados conectado ao DOUT do HX711
  * @param gpio_sck Pino de clock conectado ao SCK do HX711
- * @return Leitura bruta de 24 bits do sensor
+ * @return Leitura bruta de 24 bits do sensor (com sinal), ou HX711_READ_ERROR em caso de timeout
  */
 int32_t hx711_read(uint32_t gpio_dt, uint32_t gpio_sck);
 
+/**
+ * Seleciona canal e ganho das próximas conversões
+ *
+ * O novo ganho segue pela TX FIFO do PIO e é aplicado nos pulsos extras de
+ * SCK da conversão seguinte. As HX711_SETTLE_DISCARD conversões seguintes
+ * (ainda com o ganho antigo ou em acomodação) são descartadas por
+ * hx711_read() e hx711_stream_read().
+ *
+ * Nunca bloqueia: com o HX711 em power-down, o ganho é guardado e enviado
+ * por hx711_power_up(); no modo contínuo, se a máquina de estados ainda não
+ * retirou os ganhos anteriores (DOUT parado), retorna HX711_ERROR_BUSY.
+ *
+ * @param gain Canal e ganho
+ * @return HX711_OK, HX711_ERROR_NOT_INITIALIZED, HX711_ERROR_INVALID_PARAM
+ *         ou HX711_ERROR_BUSY
+ */
+int hx711_set_gain(hx711_gain_t gain);
+
+/**
+ * @return Canal e ganho selecionados
+ */
+hx711_gain_t hx711_get_gain(void);
+
+/**
+ * Associa um pino GPIO ao pino RATE do HX711
+ *
+ * O pino é configurado como saída com a taxa atual (10 SPS até a primeira
+ * chamada a hx711_set_rate()). Em placas com RATE fixo, não chame.
+ *
+ * @param gpio_rate Pino ligado ao RATE
+ */
+void hx711_set_rate_pin(uint32_t gpio_rate);
+
+/**
+ * Alterna a taxa de conversão entre 10 e 80 SPS
+ *
+ * 80 SPS dá leituras rápidas para acompanhar movimento; 10 SPS tem menos
+ * ruído para medições em repouso. As HX711_SETTLE_DISCARD conversões
+ * seguintes são descartadas, como em hx711_set_gain().
+ *
+ * @param rate Taxa
+ * @return HX711_OK, HX711_ERROR_NO_RATE_PIN ou HX711_ERROR_INVALID_PARAM
+ */
+int hx711_set_rate(hx711_rate_t rate);
+
+/**
+ * @return Taxa selecionada
+ */
+hx711_rate_t hx711_get_rate(void);
+
+/**
+ * Coloca o HX711 em power-down
+ *
+ * Para a máquina de estados e mantém o SCK em HIGH, que após 60 µs desliga o
+ * conversor (consumo abaixo de 1 µA). hx711_read() retorna HX711_READ_ERROR
+ * até hx711_power_up().
+ *
+ * @return HX711_OK, HX711_ERROR_NOT_INITIALIZED ou HX711_ERROR_STREAMING
+ */
+int hx711_power_down(void);
+
+/**
+ * Religa o HX711 e retoma as conversões
+ *
+ * O HX711 reinicia em canal A/128 e o ganho selecionado volta a valer a
+ * partir da segunda conversão. As conversões dos primeiros
+ * HX711_POWER_UP_MS (a 10 SPS) são descartadas por hx711_read().
+ *
+ * @return HX711_OK ou HX711_ERROR_NOT_INITIALIZED
+ */
+int hx711_power_up(void);
+
+/**
+ * @return true se o HX711 estiver em power-down
+ */
+bool hx711_is_powered_down(void);
+
+/**
+ * Inicia o modo contínuo de aquisição
+ *
+ * Um canal DMA passa a drenar a RX FIFO do PIO para o anel fornecido, sem
+ * intervenção da CPU. O chamador retira lotes de amostras com
+ * hx711_stream_read() no seu próprio ritmo; a 80 SPS, um anel de 64
+ * amostras cobre 0,8 s entre retiradas. Durante o modo contínuo,
+ * hx711_read() retorna a amostra mais recente do anel.
+ *
+ * @param buffer Anel declarado com HX711_STREAM_BUFFER
+ * @param capacity Capacidade do anel em amostras (potência de 2)
+ * @return HX711_OK, HX711_ERROR_NOT_INITIALIZED, HX711_ERROR_POWERED_DOWN,
+ *         HX711_ERROR_INVALID_BUFFER ou HX711_ERROR_NO_RESOURCES
+ */
+int hx711_stream_start(int32_t *buffer, uint32_t capacity);
+
+/**
+ * Encerra o modo contínuo e libera o canal DMA
+ */
+void hx711_stream_stop(void);
+
+/**
+ * Informa quantas amostras aguardam no anel
+ *
+ * @return Número de amostras disponíveis (no máximo a capacidade do anel)
+ */
+uint32_t hx711_stream_available(void);
+
+/**
+ * Retira um lote de amostras do anel, em ordem cronológica
+ *
+ * As amostras são copiadas já como leituras de 24 bits com sinal. Se o
+ * chamador demorar mais que um anel inteiro, as mais antigas são perdidas e
+ * contabilizadas em hx711_stream_overruns().
+ *
+ * @param out Destino das amostras
+ * @param max_samples Número máximo de amostras a copiar
+ * @return Número de amostras copiadas
+ */
+uint32_t hx711_stream_read(int32_t *out, uint32_t max_samples);
+
+/**
+ * @return Total de amostras perdidas por estouro do anel desde o início do modo contínuo
+ */
+uint32_t hx711_stream_overruns(void);
+
+/**
+ * Calcula os coeficientes em ponto fixo para uma tara e um fator de escala
+ *
+ * Toda a aritmética de ponto flutuante fica aqui, fora do caminho de cada
+ * amostra. É chamada por tare_hx711() e calibrate_hx711() para atualizar
+ * hx711_coeffs.
+ *
+ * @param coeffs Coeficientes a preencher
+ * @param tare Leitura bruta correspondente a peso zero
+ * @param scale Unidades calibradas por contagem
+ */
+void hx711_compute_coeffs(hx711_coeffs_t *coeffs, int32_t tare, float scale);
+
+/**
+ * Converte a leitura bruta em peso usando coeficientes em ponto fixo
+ *
+ * Uma multiplicação de 64 bits, uma soma e um deslocamento, sem emulação de
+ * ponto flutuante. O resultado é saturado em [min_mg, max_mg].
+ *
+ * @param coeffs Coeficientes calculados por hx711_compute_coeffs()
+ * @param reading Leitura bruta do sensor
+ * @return Peso em milésimos da unidade de calibração (mg se calibrado em gramas)
+ */
+static inline int32_t hx711_apply_coeffs(const hx711_coeffs_t *coeffs, int32_t reading) {
+    int64_t weight = ((int64_t)reading * coeffs->scale_q + coeffs->bias_q) >> HX711_Q_FRAC_BITS;
+    if (weight > coeffs->max_mg) return coeffs->max_mg;
+    if (weight < coeffs->min_mg) return coeffs->min_mg;
+    return (int32_t)weight;
+}
+
+/**
+ * Converte a leitura bruta do sensor para o peso em miligramas (ponto fixo)
+ *
+ * @param reading Leitura bruta do sensor
+ * @return Peso em milésimos da unidade de calibração (mg se calibrado em gramas)
+ */
+int32_t calculate_weight_mg(int32_t reading);
+
+/**
+ * Converte um lote de leituras brutas em peso (ponto fixo)
+ *
+ * Aplica tara, escala e saturação em um único laço desenrolado. Os
+ * coeficientes são lidos uma vez por lote, e não a cada amostra. Pensado
+ * para converter de uma vez o lote retirado com hx711_stream_read().
+ * É permitido converter no próprio buffer (out_mg == raw).
+ *
+ * @param raw Leituras brutas do sensor
+ * @param out_mg Destino dos pesos em milésimos da unidade de calibração
+ * @param n Número de leituras
+ */
+void hx711_convert_batch(const int32_t *raw, int32_t *out_mg, size_t n);
+
+/**
+ * Define a faixa de saturação aplicada às conversões em ponto fixo
+ *
+ * Útil para descartar leituras negativas causadas por deriva da tara ou
+ * para limitar ao fundo de escala da célula de carga. Por padrão, a faixa é
+ * a de int32_t.
+ *
+ * @param min_mg Peso mínimo retornado
+ * @param max_mg Peso máximo retornado
+ */
+void hx711_set_limits(int32_t min_mg, int32_t max_mg);
+
 /**
  * Converte a leitura bruta do sensor para o peso real em unidades calibradas
- * 
+ *
+ * Invólucro de calculate_weight_mg() para quem precisa de float.
+ *
  * @param reading Leitura bruta do sensor
  * @return Peso em unidades calibradas
  */
 float calculate_weight(int32_t reading);
 
+/**
+ * Define a tara (leitura bruta sem carga) usada nas conversões de peso
+ *
+ * @param zero_reading Leitura bruta do sensor sem nenhum peso
+ */
+void tare_hx711(int32_t zero_reading);
+
 /**
  * Calibra a balança utilizando um peso conhecido como referência
- * 
+ *
+ * Recalcula scale_factor e os coeficientes em ponto fixo. Informe o peso em
+ * gramas para que calculate_weight_mg() retorne miligramas.
+ *
  * @param known_weight_reading Leitura bruta do sensor com o peso conhecido
  * @param actual_weight O peso real utilizado para calibração
  */
 void calibrate_hx711(int32_t known_weight_reading, float actual_weight);
 
-#endif
\ No newline at end of file
+#endif
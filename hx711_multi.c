@@ -0,0 +1,172 @@
+#include "hx711_multi.h"
+#include "pico/stdlib.h"
+#include "hardware/irq.h"
+#include "hardware/pio.h"
+#include "hardware/sync.h"
+#include "hx711.pio.h"
+
+// Constantes do modo multicanal
+#define HX711_MULTI_READ_TIMEOUT_US 150000   // Maior que um período de conversão a 10 SPS (100ms)
+#define HX711_MULTI_PIO_IRQ_INDEX 1          // Linha de interrupção do PIO usada para "dado pronto"
+
+// Estado do modo multicanal
+typedef struct {
+    bool initialized;            // Indicador de inicialização
+    PIO pio;                     // Bloco PIO
+    uint sm;                     // Máquina de estados reservada
+    uint offset;                 // Endereço do programa na memória do PIO
+    uint irq_num;                // Interrupção do PIO (linha HX711_MULTI_PIO_IRQ_INDEX)
+    uint32_t channels;           // Células ligadas
+    hx711_coeffs_t coeffs[HX711_MULTI_MAX_CHANNELS]; // Calibração de cada célula
+} hx711_multi_state_t;
+
+static hx711_multi_state_t hx711_multi_state;
+
+// Fonte "RX FIFO não vazia" da máquina de estados multicanal
+static inline pio_interrupt_source_t hx711_multi_ready_source(void) {
+    return (pio_interrupt_source_t)(pis_sm0_rx_fifo_not_empty + hx711_multi_state.sm);
+}
+
+// Conversão pronta: desarma a fonte e acorda quem espera em WFE
+static void hx711_multi_ready_irq_handler(void) {
+    uint32_t mask = 1u << (pis_sm0_rx_fifo_not_empty + hx711_multi_state.sm);
+    if ((hx711_multi_state.pio->ints1 & mask) == 0) {
+        return;
+    }
+    pio_set_irqn_source_enabled(hx711_multi_state.pio, HX711_MULTI_PIO_IRQ_INDEX, hx711_multi_ready_source(), false);
+    __sev();
+}
+
+// Reserva uma máquina de estados e carrega o programa em pio0 ou pio1
+static int hx711_multi_claim_pio(void) {
+    PIO blocks[2] = {pio0, pio1};
+
+    for (int i = 0; i < 2; i++) {
+        if (!pio_can_add_program(blocks[i], &hx711_multi_program)) {
+            continue;
+        }
+        int claimed = pio_claim_unused_sm(blocks[i], false);
+        if (claimed < 0) {
+            continue;
+        }
+        hx711_multi_state.pio = blocks[i];
+        hx711_multi_state.sm = (uint)claimed;
+        hx711_multi_state.offset = pio_add_program(blocks[i], &hx711_multi_program);
+        return HX711_MULTI_OK;
+    }
+    return HX711_MULTI_ERROR_NO_RESOURCES;
+}
+
+// Junta em um byte os bits de um canal, espaçados de 4 em 4 na palavra
+static inline uint32_t hx711_multi_gather(uint32_t word, uint32_t channel) {
+    uint32_t x = (word >> channel) & 0x11111111u;
+    x = (x | (x >> 3)) & 0x03030303u;
+    x = (x | (x >> 6)) & 0x000F000Fu;
+    return (x | (x >> 12)) & 0xFFu;
+}
+
+// Inicializa o modo multicanal
+int hx711_multi_init(uint32_t gpio_dt_base, uint32_t channels, uint32_t gpio_sck) {
+    hx711_multi_state_t *state = &hx711_multi_state;
+
+    if (channels == 0 || channels > HX711_MULTI_MAX_CHANNELS) {
+        return HX711_MULTI_ERROR_INVALID_CHANNELS;
+    }
+
+    if (!state->initialized) {
+        int result = hx711_multi_claim_pio();
+        if (result != HX711_MULTI_OK) return result;
+
+        state->irq_num = pio_get_irq_num(state->pio, HX711_MULTI_PIO_IRQ_INDEX);
+        irq_add_shared_handler(state->irq_num, hx711_multi_ready_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(state->irq_num, true);
+    } else {
+        pio_sm_set_enabled(state->pio, state->sm, false);
+        pio_sm_clear_fifos(state->pio, state->sm);
+    }
+
+    hx711_multi_program_init(state->pio, state->sm, state->offset, gpio_dt_base, channels, gpio_sck);
+    pio_sm_set_enabled(state->pio, state->sm, true);
+
+    for (uint32_t i = 0; i < HX711_MULTI_MAX_CHANNELS; i++) {
+        hx711_compute_coeffs(&state->coeffs[i], 0, 1.0f);
+        state->coeffs[i].min_mg = INT32_MIN;
+        state->coeffs[i].max_mg = INT32_MAX;
+    }
+    state->channels = channels;
+    state->initialized = true;
+
+    return HX711_MULTI_OK;
+}
+
+// Lê a conversão mais recente de todas as células
+int hx711_multi_read(int32_t *raw) {
+    hx711_multi_state_t *state = &hx711_multi_state;
+    uint32_t words[HX711_MULTI_FRAME_WORDS];
+
+    if (!state->initialized) {
+        return HX711_MULTI_ERROR_NOT_INITIALIZED;
+    }
+    PIO pio = state->pio;
+    uint sm = state->sm;
+
+    // A FIFO só recebe quadros inteiros e é lida de quadro em quadro: a cabeça
+    // está sempre alinhada. Descarta os quadros completos mais antigos.
+    while (pio_sm_get_rx_fifo_level(pio, sm) >= 2 * HX711_MULTI_FRAME_WORDS) {
+        for (uint32_t w = 0; w < HX711_MULTI_FRAME_WORDS; w++) {
+            (void)pio_sm_get(pio, sm);
+        }
+    }
+
+    // As palavras de um quadro chegam a poucos µs umas das outras
+    absolute_time_t deadline = make_timeout_time_us(HX711_MULTI_READ_TIMEOUT_US);
+    for (uint32_t w = 0; w < HX711_MULTI_FRAME_WORDS; w++) {
+        while (pio_sm_is_rx_fifo_empty(pio, sm)) {
+            if (time_reached(deadline)) {
+                pio_set_irqn_source_enabled(pio, HX711_MULTI_PIO_IRQ_INDEX, hx711_multi_ready_source(), false);
+                return HX711_MULTI_ERROR_TIMEOUT;
+            }
+            pio_set_irqn_source_enabled(pio, HX711_MULTI_PIO_IRQ_INDEX, hx711_multi_ready_source(), true);
+            best_effort_wfe_or_timeout(deadline);
+        }
+        words[w] = pio_sm_get(pio, sm);
+    }
+
+    // Separa os canais intercalados e estende o sinal dos 24 bits
+    for (uint32_t c = 0; c < state->channels; c++) {
+        uint32_t value = (hx711_multi_gather(words[0], c) << 16) | (hx711_multi_gather(words[1], c) << 8) |
+                         hx711_multi_gather(words[2], c);
+        raw[c] = (int32_t)(value << 8) >> 8;
+    }
+    return HX711_MULTI_OK;
+}
+
+// Define a calibração de uma célula
+void hx711_multi_set_coeffs(uint32_t channel, const hx711_coeffs_t *coeffs) {
+    if (channel < HX711_MULTI_MAX_CHANNELS) {
+        hx711_multi_state.coeffs[channel] = *coeffs;
+    }
+}
+
+// Soma o peso das células
+int32_t hx711_multi_weight_mg(const int32_t *raw) {
+    int64_t total = 0;
+
+    for (uint32_t c = 0; c < hx711_multi_state.channels; c++) {
+        total += hx711_apply_coeffs(&hx711_multi_state.coeffs[c], raw[c]);
+    }
+    if (total > INT32_MAX) return INT32_MAX;
+    if (total < INT32_MIN) return INT32_MIN;
+    return (int32_t)total;
+}
+
+// Lê todas as células e retorna o peso total
+int hx711_multi_read_mg(int32_t *weight_mg) {
+    int32_t raw[HX711_MULTI_MAX_CHANNELS];
+
+    int result = hx711_multi_read(raw);
+    if (result == HX711_MULTI_OK) {
+        *weight_mg = hx711_multi_weight_mg(raw);
+    }
+    return result;
+}
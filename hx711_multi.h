@@ -0,0 +1,71 @@
+#ifndef HX711_MULTI_H
+#define HX711_MULTI_H
+
+#include <stdint.h>
+#include "hx711.h"
+
+// Códigos de retorno do modo multicanal
+#define HX711_MULTI_OK 0                        // Operação bem-sucedida
+#define HX711_MULTI_ERROR_NO_RESOURCES -1       // Sem máquina de estados PIO livre
+#define HX711_MULTI_ERROR_INVALID_CHANNELS -2   // Número de canais fora de 1..HX711_MULTI_MAX_CHANNELS
+#define HX711_MULTI_ERROR_NOT_INITIALIZED -3    // hx711_multi_init() não foi chamada
+#define HX711_MULTI_ERROR_TIMEOUT -4            // Nenhuma conversão chegou a tempo
+
+// Células de carga lidas por uma única máquina de estados
+#define HX711_MULTI_MAX_CHANNELS 4
+
+/**
+ * Inicializa o modo multicanal: vários HX711 com um SCK compartilhado
+ *
+ * Os DOUT devem estar em pinos consecutivos a partir de gpio_dt_base. Um
+ * único programa PIO gera os pulsos de SCK e amostra todos os DOUT a cada
+ * pulso, de modo que as células são lidas na mesma janela de conversão e o
+ * tempo de leitura não cresce com o número de células. O ganho fica fixo em
+ * canal A/128. Instala, no núcleo que chama, o tratador compartilhado da
+ * linha 1 de interrupção do PIO usado por hx711_multi_read().
+ *
+ * Os coeficientes de todas as células começam com escala 1,0 e tara zero.
+ *
+ * @param gpio_dt_base Pino do DOUT da célula 0
+ * @param channels Número de células (1..HX711_MULTI_MAX_CHANNELS)
+ * @param gpio_sck Pino do SCK compartilhado
+ * @return HX711_MULTI_OK, HX711_MULTI_ERROR_INVALID_CHANNELS ou HX711_MULTI_ERROR_NO_RESOURCES
+ */
+int hx711_multi_init(uint32_t gpio_dt_base, uint32_t channels, uint32_t gpio_sck);
+
+/**
+ * Lê a conversão mais recente de todas as células
+ *
+ * Conversões antigas na FIFO são descartadas. Sem nenhuma, o núcleo dorme
+ * (WFE) até a interrupção de RX FIFO não vazia do PIO.
+ *
+ * @param raw Destino das leituras brutas de 24 bits (uma por célula)
+ * @return HX711_MULTI_OK, HX711_MULTI_ERROR_NOT_INITIALIZED ou HX711_MULTI_ERROR_TIMEOUT
+ */
+int hx711_multi_read(int32_t *raw);
+
+/**
+ * Define a calibração de uma célula
+ *
+ * @param channel Índice da célula
+ * @param coeffs Coeficientes calculados por hx711_compute_coeffs()
+ */
+void hx711_multi_set_coeffs(uint32_t channel, const hx711_coeffs_t *coeffs);
+
+/**
+ * Soma o peso das células, cada uma com a sua calibração
+ *
+ * @param raw Leituras brutas obtidas com hx711_multi_read()
+ * @return Peso total em milésimos da unidade de calibração (saturado em int32_t)
+ */
+int32_t hx711_multi_weight_mg(const int32_t *raw);
+
+/**
+ * Lê todas as células e retorna o peso total
+ *
+ * @param weight_mg Peso total em milésimos da unidade de calibração
+ * @return HX711_MULTI_OK, HX711_MULTI_ERROR_NOT_INITIALIZED ou HX711_MULTI_ERROR_TIMEOUT
+ */
+int hx711_multi_read_mg(int32_t *weight_mg);
+
+#endif
@@ -0,0 +1,85 @@
+#include "metrics.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+// Correntes típicas usadas na estimativa de consumo (placa Pico W a 125 MHz)
+#define METRICS_BASE_UA 7000           // Ambos os núcleos em WFE, relógios ligados
+#define METRICS_CORE_BUSY_UA 6000      // Acréscimo de cada núcleo executando
+#define METRICS_RADIO_UA 45000         // CYW43 associado e transmitindo
+#define METRICS_HX711_UA 1500          // HX711 convertendo (abaixo de 1 µA em power-down)
+#define METRICS_DHT22_UA 600           // Dois DHT22, média entre medição e repouso
+#define METRICS_UA_MS_PER_UAH 3600000u // µA·ms em 1 µAh
+
+// Contadores de um núcleo: escritos só por ele, lidos por qualquer um
+typedef struct {
+    volatile uint32_t values[METRICS_COUNTER_COUNT];
+    uint16_t remainder_us[METRICS_COUNTER_COUNT]; // Frações de ms de metrics_add_us()
+} metrics_core_t;
+
+static metrics_core_t metrics_cores[METRICS_CORES];
+
+// Soma um valor a um contador do núcleo atual
+void metrics_add(metrics_counter_t counter, uint32_t value) {
+    metrics_core_t *core = &metrics_cores[get_core_num()];
+
+    // O Cortex-M0+ não tem LDREX/STREX: a soma só é protegida das interrupções do próprio núcleo
+    uint32_t irq = save_and_disable_interrupts();
+    core->values[counter] += value;
+    restore_interrupts(irq);
+}
+
+// Soma um intervalo em µs a um contador em ms, guardando a fração
+void metrics_add_us(metrics_counter_t counter, uint64_t us) {
+    metrics_core_t *core = &metrics_cores[get_core_num()];
+
+    uint32_t irq = save_and_disable_interrupts();
+    uint64_t total_us = core->remainder_us[counter] + us;
+    core->values[counter] += (uint32_t)(total_us / 1000);
+    core->remainder_us[counter] = (uint16_t)(total_us % 1000);
+    restore_interrupts(irq);
+}
+
+// Define um medidor
+void metrics_set(metrics_counter_t counter, uint32_t value) {
+    metrics_cores[get_core_num()].values[counter] = value;
+}
+
+// Eleva um medidor (marca de máximo)
+void metrics_max(metrics_counter_t counter, uint32_t value) {
+    metrics_core_t *core = &metrics_cores[get_core_num()];
+
+    uint32_t irq = save_and_disable_interrupts();
+    if (value > core->values[counter]) {
+        core->values[counter] = value;
+    }
+    restore_interrupts(irq);
+}
+
+// Lê as métricas dos dois núcleos e calcula ocupação e consumo
+void metrics_snapshot(metrics_snapshot_t *snapshot) {
+    snapshot->uptime_ms = to_ms_since_boot(get_absolute_time());
+
+    for (uint32_t c = 0; c < METRICS_COUNTER_COUNT; c++) {
+        snapshot->counters[c] = 0;
+        for (uint32_t core = 0; core < METRICS_CORES; core++) {
+            snapshot->counters[c] += metrics_cores[core].values[c];
+        }
+    }
+
+    uint64_t busy_ms = 0;
+    for (uint32_t core = 0; core < METRICS_CORES; core++) {
+        uint32_t idle = metrics_cores[core].values[METRICS_IDLE_MS];
+        uint32_t busy = snapshot->uptime_ms > idle ? snapshot->uptime_ms - idle : 0;
+        snapshot->idle_ms[core] = idle;
+        snapshot->busy_permille[core] =
+            snapshot->uptime_ms ? (uint32_t)((uint64_t)busy * 1000 / snapshot->uptime_ms) : 0;
+        busy_ms += busy;
+    }
+
+    // Carga = soma de corrente x tempo de cada componente
+    uint64_t charge = (uint64_t)METRICS_BASE_UA * snapshot->uptime_ms + (uint64_t)METRICS_CORE_BUSY_UA * busy_ms +
+                      (uint64_t)METRICS_RADIO_UA * snapshot->counters[METRICS_RADIO_ON_MS] +
+                      (uint64_t)METRICS_HX711_UA * snapshot->counters[METRICS_HX711_ON_MS] +
+                      (uint64_t)METRICS_DHT22_UA * snapshot->counters[METRICS_DHT22_ON_MS];
+    snapshot->charge_uah = (uint32_t)(charge / METRICS_UA_MS_PER_UAH);
+}
@@ -0,0 +1,86 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+
+// Núcleos com contadores próprios
+#define METRICS_CORES 2
+
+// Contadores (cumulativos, com retorno a zero em 2^32) e medidores
+typedef enum {
+    METRICS_IDLE_MS,             // Tempo dormindo em WFE
+    METRICS_TASK_RUNS,           // Tarefas executadas pelo escalonador
+    METRICS_QUEUE_HIGH_WATER,    // Medidor: maior ocupação da fila de amostras
+    METRICS_SAMPLES_DROPPED,     // Medidor: amostras descartadas por fila cheia
+    METRICS_LOG_PENDING,         // Medidor: lotes aguardando envio no log da flash
+    METRICS_HX711_READS,         // Leituras isoladas do HX711
+    METRICS_HX711_ERRORS,        // Leituras isoladas sem conversão a tempo
+    METRICS_HX711_OVERRUNS,      // Amostras sobrescritas no anel do DMA
+    METRICS_DHT22_FRAMES,        // Quadros solicitados aos DHT22
+    METRICS_DHT22_ERRORS,        // Quadros com checksum, timeout ou valores inválidos
+    METRICS_UPLINK_BATCHES,      // Lotes enviados pelo rádio
+    METRICS_UPLINK_ERRORS,       // Conexões que falharam
+    METRICS_RADIO_ON_MS,         // Tempo com o CYW43 ligado
+    METRICS_HX711_ON_MS,         // Tempo com o HX711 fora do power-down
+    METRICS_DHT22_ON_MS,         // Tempo com a alimentação dos DHT22 ligada
+    METRICS_COUNTER_COUNT
+} metrics_counter_t;
+
+/**
+ * Retrato das métricas, somadas entre os núcleos.
+ *
+ * O consumo é uma estimativa: cada tempo medido é multiplicado pela
+ * corrente típica do componente (constantes METRICS_*_UA em metrics.c).
+ */
+typedef struct {
+    uint32_t uptime_ms;          // Tempo desde a partida
+    uint32_t idle_ms[METRICS_CORES];       // Tempo em WFE de cada núcleo
+    uint32_t busy_permille[METRICS_CORES]; // Ocupação de cada núcleo em ‰
+    uint32_t charge_uah;         // Carga estimada desde a partida, em µAh
+    uint32_t counters[METRICS_COUNTER_COUNT];
+} metrics_snapshot_t;
+
+/**
+ * Soma um valor a um contador do núcleo atual
+ *
+ * Cada núcleo escreve apenas nos próprios contadores: não há trava entre
+ * núcleos, e as interrupções ficam desabilitadas só durante a soma. Pode ser
+ * chamada de interrupções.
+ *
+ * @param counter Contador
+ * @param value Valor a somar
+ */
+void metrics_add(metrics_counter_t counter, uint32_t value);
+
+/**
+ * Soma um intervalo a um contador de tempo em ms, sem perder as frações
+ *
+ * @param counter Contador de tempo (METRICS_*_MS)
+ * @param us Intervalo em µs (de 64 bits: uma alimentação pode ficar ligada por horas)
+ */
+void metrics_add_us(metrics_counter_t counter, uint64_t us);
+
+/**
+ * Define um medidor; deve ser escrito sempre pelo mesmo núcleo
+ *
+ * @param counter Medidor
+ * @param value Valor atual
+ */
+void metrics_set(metrics_counter_t counter, uint32_t value);
+
+/**
+ * Eleva um medidor ao valor informado, se for maior (marca de máximo)
+ *
+ * @param counter Medidor
+ * @param value Valor observado
+ */
+void metrics_max(metrics_counter_t counter, uint32_t value);
+
+/**
+ * Lê as métricas dos dois núcleos e calcula ocupação e consumo
+ *
+ * @param snapshot Destino
+ */
+void metrics_snapshot(metrics_snapshot_t *snapshot);
+
+#endif
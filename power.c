@@ -0,0 +1,114 @@
+#include "power.h"
+#include "pico/stdlib.h"
+
+// Verifica se o identificador corresponde a uma alimentação registrada
+static inline bool power_valid_rail(const power_t *power, int rail) {
+    return rail >= 0 && (uint32_t)rail < power->count;
+}
+
+// Contabiliza o tempo ligado desde a última contagem
+static void power_accrue(power_rail_t *r) {
+    if (!r->on) {
+        return;
+    }
+    absolute_time_t now = get_absolute_time();
+    uint64_t elapsed_us = (uint64_t)absolute_time_diff_us(r->on_since, now); // 32 bits voltariam a zero em ~71 min
+    r->on_time_us += elapsed_us;
+    r->on_since = now;
+    metrics_add_us(r->metric, elapsed_us);
+}
+
+// Liga a alimentação e marca o fim do aquecimento
+static void power_switch_on(power_rail_t *r) {
+    if (r->fn != NULL) {
+        r->fn(r->context, true);
+    }
+    r->on = true;
+    r->on_since = get_absolute_time();
+    r->ready_at = delayed_by_ms(r->on_since, r->warmup_ms);
+}
+
+// Inicializa um gerenciador sem alimentações
+void power_init(power_t *power) {
+    power->count = 0;
+}
+
+// Registra uma alimentação, inicialmente ligada
+int power_add_rail(power_t *power, power_switch_fn_t fn, void *context, uint32_t warmup_ms,
+                   metrics_counter_t metric) {
+    if (power->count >= POWER_MAX_RAILS) {
+        return POWER_ERROR_FULL;
+    }
+
+    power_rail_t *r = &power->rails[power->count];
+    r->fn = fn;
+    r->context = context;
+    r->warmup_ms = warmup_ms;
+    r->metric = metric;
+    r->on_time_us = 0;
+    power_switch_on(r);
+
+    return (int)power->count++;
+}
+
+// Liga a alimentação se necessário e informa quanto falta para o sensor ficar utilizável
+uint32_t power_acquire(power_t *power, int rail) {
+    if (!power_valid_rail(power, rail)) {
+        return 0;
+    }
+
+    power_rail_t *r = &power->rails[rail];
+    if (r->on) {
+        power_accrue(r); // Alimentação que nunca desliga também entra na estimativa
+    } else {
+        power_switch_on(r);
+    }
+
+    int64_t remaining_us = absolute_time_diff_us(get_absolute_time(), r->ready_at);
+    if (remaining_us <= 0) {
+        return 0;
+    }
+    return (uint32_t)((remaining_us + 999) / 1000); // Arredonda para cima: nunca 0 com aquecimento pendente
+}
+
+// Desliga a alimentação até o aquecimento anterior ao próximo uso
+uint32_t power_release(power_t *power, int rail, uint32_t next_use_ms) {
+    if (!power_valid_rail(power, rail)) {
+        return next_use_ms;
+    }
+
+    power_rail_t *r = &power->rails[rail];
+    if (r->fn == NULL) {
+        power_accrue(r); // Alimentação fixa: só contabiliza o tempo ligado
+        return next_use_ms;
+    }
+    if (next_use_ms <= r->warmup_ms) {
+        return next_use_ms; // Religaria antes de economizar algo: permanece ligada
+    }
+
+    if (r->on) {
+        power_accrue(r);
+        r->fn(r->context, false);
+        r->on = false;
+    }
+    return next_use_ms - r->warmup_ms;
+}
+
+// Indica se a alimentação está ligada
+bool power_is_on(const power_t *power, int rail) {
+    return power_valid_rail(power, rail) && power->rails[rail].on;
+}
+
+// Tempo total com a alimentação ligada
+uint32_t power_on_time_ms(const power_t *power, int rail) {
+    if (!power_valid_rail(power, rail)) {
+        return 0;
+    }
+
+    const power_rail_t *r = &power->rails[rail];
+    uint64_t on_us = r->on_time_us;
+    if (r->on) {
+        on_us += (uint64_t)absolute_time_diff_us(r->on_since, get_absolute_time());
+    }
+    return (uint32_t)(on_us / 1000);
+}
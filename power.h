@@ -0,0 +1,109 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/time.h"
+#include "metrics.h"
+
+// Códigos de retorno do gerenciador de energia
+#define POWER_OK 0                        // Operação bem-sucedida
+#define POWER_ERROR_FULL -1               // Número máximo de alimentações atingido
+#define POWER_ERROR_INVALID_RAIL -2       // Identificador de alimentação inválido
+
+// Número máximo de alimentações chaveadas
+#define POWER_MAX_RAILS 4
+
+// Liga (on = true) ou desliga a alimentação de um sensor
+typedef void (*power_switch_fn_t)(void *context, bool on);
+
+// Alimentação chaveada de um ou mais sensores
+typedef struct {
+    power_switch_fn_t fn;        // Função que liga/desliga
+    void *context;               // Contexto repassado à função
+    uint32_t warmup_ms;          // Tempo entre ligar e o sensor ficar utilizável
+    bool on;                     // Alimentação ligada
+    absolute_time_t on_since;    // Início do tempo ligado ainda não contabilizado
+    absolute_time_t ready_at;    // Horário em que o sensor fica utilizável
+    uint64_t on_time_us;         // Tempo ligado acumulado até on_since
+    metrics_counter_t metric;    // Contador de tempo ligado (METRICS_*_ON_MS)
+} power_rail_t;
+
+/**
+ * Gerenciador de energia dos sensores de um núcleo.
+ *
+ * Cada alimentação conhece o tempo de aquecimento do seu sensor, de modo que
+ * a tarefa que o lê pode ligá-lo apenas esse tempo antes da leitura e
+ * desligá-lo em seguida: power_acquire() no início da tarefa e
+ * power_release() no fim, com o escalonador devolvendo o controle entre as
+ * duas. Todas as funções devem ser chamadas do mesmo núcleo.
+ */
+typedef struct {
+    power_rail_t rails[POWER_MAX_RAILS];
+    uint32_t count;              // Alimentações registradas
+} power_t;
+
+/**
+ * Inicializa um gerenciador sem alimentações
+ *
+ * @param power Gerenciador a inicializar
+ */
+void power_init(power_t *power);
+
+/**
+ * Registra uma alimentação, inicialmente ligada
+ *
+ * Com fn == NULL, a alimentação é fixa (sensor ligado direto ao 3V3): nunca
+ * desliga, mas o tempo ligado continua entrando na estimativa de consumo.
+ *
+ * @param power Gerenciador
+ * @param fn Função que liga/desliga a alimentação, ou NULL para alimentação fixa
+ * @param context Contexto repassado à função
+ * @param warmup_ms Tempo entre ligar e o sensor ficar utilizável
+ * @param metric Contador que acumula o tempo ligado, para a estimativa de consumo
+ * @return Identificador da alimentação (>= 0) ou POWER_ERROR_FULL
+ */
+int power_add_rail(power_t *power, power_switch_fn_t fn, void *context, uint32_t warmup_ms,
+                   metrics_counter_t metric);
+
+/**
+ * Garante que a alimentação está ligada e o sensor utilizável
+ *
+ * Liga a alimentação se necessário. Se o aquecimento ainda não terminou,
+ * retorna quanto falta: a tarefa reagenda-se para esse prazo e retorna, em
+ * vez de esperar.
+ *
+ * @param power Gerenciador
+ * @param rail Identificador retornado por power_add_rail()
+ * @return 0 se o sensor já pode ser lido, ou o tempo restante em ms
+ */
+uint32_t power_acquire(power_t *power, int rail);
+
+/**
+ * Desliga a alimentação até pouco antes do próximo uso
+ *
+ * Só desliga se o intervalo for maior que o tempo de aquecimento; caso
+ * contrário, mantém a alimentação ligada.
+ *
+ * @param power Gerenciador
+ * @param rail Identificador retornado por power_add_rail()
+ * @param next_use_ms Tempo até a próxima leitura do sensor
+ * @return Período até a próxima execução da tarefa (chamando power_acquire())
+ */
+uint32_t power_release(power_t *power, int rail, uint32_t next_use_ms);
+
+/**
+ * @param power Gerenciador
+ * @param rail Identificador retornado por power_add_rail()
+ * @return true se a alimentação estiver ligada
+ */
+bool power_is_on(const power_t *power, int rail);
+
+/**
+ * @param power Gerenciador
+ * @param rail Identificador retornado por power_add_rail()
+ * @return Tempo total com a alimentação ligada, em ms
+ */
+uint32_t power_on_time_ms(const power_t *power, int rail);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef RAM_FUNC_H
+#define RAM_FUNC_H
+
+#include "pico/stdlib.h"
+
+// Código com temporização crítica em SRAM (opção SMART_BAG_RAM_FUNCS do CMake)
+#ifndef SMART_BAG_RAM_FUNCS
+#define SMART_BAG_RAM_FUNCS 0
+#endif
+
+/**
+ * Marca uma função de temporização crítica.
+ *
+ * Com SMART_BAG_RAM_FUNCS, a função é copiada para a SRAM na partida e
+ * executa sem depender do cache XIP: uma falta de cache custa vários µs e
+ * distorce a medição de pulsos. O pool de literais (constantes carregadas
+ * pela função) acompanha o código, e funções static inline do SDK, como
+ * gpio_get() e time_us_32(), são expandidas dentro dela. Sem a opção, a
+ * função permanece na flash.
+ *
+ * Uso: static int RAM_FUNC(nome)(parâmetros) { ... }
+ */
+#if SMART_BAG_RAM_FUNCS
+#define RAM_FUNC(name) __not_in_flash_func(name)
+#else
+#define RAM_FUNC(name) name
+#endif
+
+#endif
@@ -0,0 +1,88 @@
+#include "sample_queue.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+
+#define SAMPLE_QUEUE_MASK (SAMPLE_QUEUE_CAPACITY - 1)
+
+_Static_assert((SAMPLE_QUEUE_CAPACITY & SAMPLE_QUEUE_MASK) == 0, "SAMPLE_QUEUE_CAPACITY deve ser potência de 2");
+
+// Inicializa uma fila vazia
+void sample_queue_init(sample_queue_t *queue) {
+    queue->head = 0;
+    queue->tail = 0;
+    queue->dropped = 0;
+    queue->high_water = 0;
+}
+
+// Insere um lote de amostras (lado do produtor)
+uint32_t sample_queue_push_batch(sample_queue_t *queue, const sample_t *samples, uint32_t count) {
+    uint32_t head = queue->head;
+    uint32_t tail = queue->tail;
+    __mem_fence_acquire(); // Lê tail antes de reutilizar as posições liberadas
+
+    uint32_t space = SAMPLE_QUEUE_CAPACITY - (head - tail);
+    uint32_t accepted = count < space ? count : space;
+
+    for (uint32_t i = 0; i < accepted; i++) {
+        queue->items[(head + i) & SAMPLE_QUEUE_MASK] = samples[i];
+    }
+
+    // As amostras precisam estar visíveis antes do novo head
+    __mem_fence_release();
+    queue->head = head + accepted;
+
+    // Ocupação logo após a inserção (o consumidor só pode tê-la reduzido)
+    uint32_t depth = head + accepted - tail;
+    if (depth > queue->high_water) {
+        queue->high_water = depth;
+    }
+    if (accepted < count) {
+        queue->dropped += count - accepted;
+    }
+    return accepted;
+}
+
+// Insere uma amostra (lado do produtor)
+bool sample_queue_push(sample_queue_t *queue, const sample_t *sample) {
+    return sample_queue_push_batch(queue, sample, 1) == 1;
+}
+
+// Retira até max_samples amostras (lado do consumidor)
+uint32_t sample_queue_pop_batch(sample_queue_t *queue, sample_t *samples, uint32_t max_samples) {
+    uint32_t tail = queue->tail;
+    uint32_t head = queue->head;
+    __mem_fence_acquire(); // Lê head antes do conteúdo das amostras
+
+    uint32_t available = head - tail;
+    uint32_t count = available < max_samples ? available : max_samples;
+
+    for (uint32_t i = 0; i < count; i++) {
+        samples[i] = queue->items[(tail + i) & SAMPLE_QUEUE_MASK];
+    }
+
+    // As cópias precisam terminar antes de liberar as posições ao produtor
+    __mem_fence_release();
+    queue->tail = tail + count;
+
+    return count;
+}
+
+// Retira uma amostra (lado do consumidor)
+bool sample_queue_pop(sample_queue_t *queue, sample_t *sample) {
+    return sample_queue_pop_batch(queue, sample, 1) == 1;
+}
+
+// Amostras aguardando o consumidor
+uint32_t sample_queue_count(const sample_queue_t *queue) {
+    return queue->head - queue->tail;
+}
+
+// Amostras descartadas por fila cheia
+uint32_t sample_queue_dropped(const sample_queue_t *queue) {
+    return queue->dropped;
+}
+
+// Maior ocupação observada
+uint32_t sample_queue_high_water(const sample_queue_t *queue) {
+    return queue->high_water;
+}
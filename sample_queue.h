@@ -0,0 +1,119 @@
+#ifndef SAMPLE_QUEUE_H
+#define SAMPLE_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Capacidade de cada fila em amostras (potência de 2)
+#ifndef SAMPLE_QUEUE_CAPACITY
+#define SAMPLE_QUEUE_CAPACITY 128
+#endif
+
+// Tipo de conteúdo de uma amostra
+typedef enum {
+    SAMPLE_KIND_HX711,           // Leitura bruta de 24 bits do HX711
+    SAMPLE_KIND_DHT22            // Temperatura/umidade de um DHT22
+} sample_kind_t;
+
+/**
+ * Amostra com horário de aquisição, comum a todos os drivers.
+ *
+ * status carrega o código de retorno do driver (HX711_OK, DHT22_ERROR_TIMEOUT,
+ * ...); com status diferente de zero, apenas kind, source e timestamp_us
+ * são significativos.
+ */
+typedef struct {
+    uint32_t timestamp_us;       // Horário da aquisição (time_us_32)
+    uint8_t kind;                // sample_kind_t
+    uint8_t source;              // Identificador do sensor (definido pela aplicação)
+    int16_t status;              // Código de retorno do driver
+    union {
+        int32_t hx711_raw;       // SAMPLE_KIND_HX711: leitura bruta com sinal
+        struct {
+            int16_t temperature_x10; // SAMPLE_KIND_DHT22: décimos de °C
+            uint16_t humidity_x10;   // SAMPLE_KIND_DHT22: décimos de %
+        } dht22;
+    };
+} sample_t;
+
+/**
+ * Fila circular sem travas com um produtor e um consumidor.
+ *
+ * O produtor (núcleo 1 ou uma interrupção) escreve apenas head e o
+ * consumidor (núcleo 0) escreve apenas tail, de modo que nenhuma operação
+ * espera pela outra: com a fila cheia, o push falha e a amostra é
+ * contabilizada em dropped. Cada fila admite exatamente um produtor e um
+ * consumidor.
+ */
+typedef struct {
+    volatile uint32_t head;      // Total de amostras escritas (produtor)
+    volatile uint32_t tail;      // Total de amostras lidas (consumidor)
+    volatile uint32_t dropped;   // Amostras descartadas por fila cheia (produtor)
+    volatile uint32_t high_water; // Maior ocupação observada (produtor)
+    sample_t items[SAMPLE_QUEUE_CAPACITY];
+} sample_queue_t;
+
+/**
+ * Inicializa uma fila vazia
+ *
+ * @param queue Fila a inicializar
+ */
+void sample_queue_init(sample_queue_t *queue);
+
+/**
+ * Insere uma amostra (lado do produtor)
+ *
+ * @param queue Fila de destino
+ * @param sample Amostra a copiar
+ * @return true se inserida, false se a fila estava cheia
+ */
+bool sample_queue_push(sample_queue_t *queue, const sample_t *sample);
+
+/**
+ * Insere um lote de amostras, publicadas de uma só vez (lado do produtor)
+ *
+ * @param queue Fila de destino
+ * @param samples Amostras a copiar
+ * @param count Número de amostras
+ * @return Número de amostras inseridas; as restantes são descartadas
+ */
+uint32_t sample_queue_push_batch(sample_queue_t *queue, const sample_t *samples, uint32_t count);
+
+/**
+ * Retira uma amostra (lado do consumidor)
+ *
+ * @param queue Fila de origem
+ * @param sample Destino da amostra
+ * @return true se havia uma amostra
+ */
+bool sample_queue_pop(sample_queue_t *queue, sample_t *sample);
+
+/**
+ * Retira até max_samples amostras em ordem (lado do consumidor)
+ *
+ * @param queue Fila de origem
+ * @param samples Destino das amostras
+ * @param max_samples Capacidade do destino
+ * @return Número de amostras retiradas
+ */
+uint32_t sample_queue_pop_batch(sample_queue_t *queue, sample_t *samples, uint32_t max_samples);
+
+/**
+ * @param queue Fila
+ * @return Número de amostras aguardando o consumidor
+ */
+uint32_t sample_queue_count(const sample_queue_t *queue);
+
+/**
+ * @param queue Fila
+ * @return Total de amostras descartadas por fila cheia
+ */
+uint32_t sample_queue_dropped(const sample_queue_t *queue);
+
+/**
+ * @param queue Fila
+ * @return Maior número de amostras aguardando o consumidor desde a inicialização
+ */
+uint32_t sample_queue_high_water(const sample_queue_t *queue);
+
+#endif
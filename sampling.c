@@ -0,0 +1,86 @@
+#include "sampling.h"
+
+// Peso da referência no repouso: acompanha a deriva com 1/8 de cada diferença
+#define SAMPLING_REFERENCE_SHIFT 3
+
+static inline int32_t sampling_abs_diff(int32_t a, int32_t b) {
+    return a > b ? a - b : b - a;
+}
+
+// Inicializa o gatilho em repouso
+void sampling_weight_init(sampling_weight_t *weight, int32_t threshold, uint32_t hold_ms) {
+    weight->threshold = threshold;
+    weight->hold_ms = hold_ms;
+    weight->mode = SAMPLING_IDLE;
+    weight->has_reference = false;
+    weight->reference = 0;
+    weight->last_change_ms = 0;
+}
+
+// Compara a leitura com a referência e decide o modo
+sampling_mode_t sampling_weight_update(sampling_weight_t *weight, int32_t raw, uint32_t now_ms) {
+    if (!weight->has_reference) {
+        weight->reference = raw;
+        weight->has_reference = true;
+        return weight->mode;
+    }
+
+    if (sampling_abs_diff(raw, weight->reference) > weight->threshold) {
+        // Peso mudou: a nova leitura passa a ser a referência
+        weight->reference = raw;
+        weight->last_change_ms = now_ms;
+        weight->mode = SAMPLING_ACTIVE;
+    } else if (weight->mode == SAMPLING_ACTIVE) {
+        if (now_ms - weight->last_change_ms >= weight->hold_ms) {
+            weight->reference = raw;
+            weight->mode = SAMPLING_IDLE;
+        }
+    } else {
+        weight->reference += (raw - weight->reference) >> SAMPLING_REFERENCE_SHIFT;
+    }
+    return weight->mode;
+}
+
+// Inicializa o intervalo em min_interval_ms
+void sampling_env_init(sampling_env_t *env, uint32_t min_interval_ms, uint32_t max_interval_ms, int16_t tolerance_x10) {
+    env->min_interval_ms = min_interval_ms;
+    env->max_interval_ms = max_interval_ms;
+    env->interval_ms = min_interval_ms;
+    env->tolerance_x10 = tolerance_x10;
+    env->changed = false;
+    for (uint32_t i = 0; i < SAMPLING_ENV_MAX_SENSORS; i++) {
+        env->reference[i].valid = false;
+    }
+}
+
+// Registra a leitura de um sensor; falhas também contam como mudança
+void sampling_env_observe(sampling_env_t *env, uint32_t sensor, bool valid, int16_t temperature_x10,
+                          uint16_t humidity_x10) {
+    if (sensor >= SAMPLING_ENV_MAX_SENSORS) {
+        return;
+    }
+
+    if (!valid) {
+        env->changed = true;
+        return;
+    }
+    if (!env->reference[sensor].valid ||
+        sampling_abs_diff(temperature_x10, env->reference[sensor].temperature_x10) > env->tolerance_x10 ||
+        sampling_abs_diff(humidity_x10, env->reference[sensor].humidity_x10) > env->tolerance_x10) {
+        env->reference[sensor].valid = true;
+        env->reference[sensor].temperature_x10 = temperature_x10;
+        env->reference[sensor].humidity_x10 = humidity_x10;
+        env->changed = true;
+    }
+}
+
+// Dobra o intervalo com valores estáveis; volta ao mínimo quando algo muda
+uint32_t sampling_env_next_interval(sampling_env_t *env) {
+    if (env->changed) {
+        env->interval_ms = env->min_interval_ms;
+    } else if (env->interval_ms < env->max_interval_ms) {
+        env->interval_ms = env->interval_ms * 2 < env->max_interval_ms ? env->interval_ms * 2 : env->max_interval_ms;
+    }
+    env->changed = false;
+    return env->interval_ms;
+}
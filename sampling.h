@@ -0,0 +1,103 @@
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Sensores de ambiente acompanhados por sampling_env_t
+#define SAMPLING_ENV_MAX_SENSORS 2
+
+// Modo de aquisição do peso
+typedef enum {
+    SAMPLING_IDLE,               // Leituras isoladas em ritmo baixo, sem DMA
+    SAMPLING_ACTIVE              // Modo contínuo do HX711 em taxa plena
+} sampling_mode_t;
+
+/**
+ * Gatilho de aquisição do peso.
+ *
+ * Em repouso, cada leitura é comparada com uma referência que acompanha
+ * lentamente a deriva térmica da célula de carga. Uma variação acima do
+ * limiar (um objeto colocado ou retirado da bolsa) passa ao modo ativo, que
+ * permanece enquanto houver variações e volta ao repouso após hold_ms sem
+ * nenhuma.
+ */
+typedef struct {
+    int32_t threshold;           // Variação que dispara o modo ativo (contagens)
+    uint32_t hold_ms;            // Tempo sem variação antes de voltar ao repouso
+    sampling_mode_t mode;        // Modo atual
+    bool has_reference;          // Referência já definida
+    int32_t reference;           // Leitura de referência
+    uint32_t last_change_ms;     // Horário da última variação acima do limiar
+} sampling_weight_t;
+
+/**
+ * Intervalo adaptativo das leituras de ambiente.
+ *
+ * A cada rodada de leituras, o intervalo dobra (até max_interval_ms) se
+ * nenhum sensor variou além da tolerância, e volta a min_interval_ms quando
+ * algum variou ou falhou.
+ */
+typedef struct {
+    uint32_t min_interval_ms;    // Intervalo com valores mudando
+    uint32_t max_interval_ms;    // Intervalo com valores estáveis
+    uint32_t interval_ms;        // Intervalo atual
+    int16_t tolerance_x10;       // Variação tolerada (décimos de °C e de %)
+    bool changed;                // Algum sensor variou na rodada atual
+    struct {
+        bool valid;              // Referência definida
+        int16_t temperature_x10; // Temperatura de referência
+        uint16_t humidity_x10;   // Umidade de referência
+    } reference[SAMPLING_ENV_MAX_SENSORS];
+} sampling_env_t;
+
+/**
+ * Inicializa o gatilho em repouso
+ *
+ * @param weight Gatilho
+ * @param threshold Variação que dispara o modo ativo (contagens do HX711)
+ * @param hold_ms Tempo sem variação antes de voltar ao repouso
+ */
+void sampling_weight_init(sampling_weight_t *weight, int32_t threshold, uint32_t hold_ms);
+
+/**
+ * Processa uma leitura do HX711
+ *
+ * @param weight Gatilho
+ * @param raw Leitura bruta
+ * @param now_ms Horário da leitura
+ * @return Modo após a leitura
+ */
+sampling_mode_t sampling_weight_update(sampling_weight_t *weight, int32_t raw, uint32_t now_ms);
+
+/**
+ * Inicializa o intervalo em min_interval_ms
+ *
+ * @param env Política de ambiente
+ * @param min_interval_ms Intervalo com valores mudando (>= intervalo mínimo do sensor)
+ * @param max_interval_ms Intervalo com valores estáveis
+ * @param tolerance_x10 Variação tolerada em décimos de °C e de %
+ */
+void sampling_env_init(sampling_env_t *env, uint32_t min_interval_ms, uint32_t max_interval_ms, int16_t tolerance_x10);
+
+/**
+ * Registra a leitura de um sensor na rodada atual
+ *
+ * @param env Política de ambiente
+ * @param sensor Índice do sensor (< SAMPLING_ENV_MAX_SENSORS)
+ * @param valid Leitura bem-sucedida
+ * @param temperature_x10 Temperatura em décimos de °C
+ * @param humidity_x10 Umidade em décimos de %
+ */
+void sampling_env_observe(sampling_env_t *env, uint32_t sensor, bool valid, int16_t temperature_x10,
+                          uint16_t humidity_x10);
+
+/**
+ * Encerra a rodada e calcula o intervalo até a próxima
+ *
+ * @param env Política de ambiente
+ * @return Intervalo em ms
+ */
+uint32_t sampling_env_next_interval(sampling_env_t *env);
+
+#endif
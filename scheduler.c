@@ -0,0 +1,166 @@
+#include "scheduler.h"
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "metrics.h"
+
+// Número máximo de pinos associados a tarefas por scheduler_wake_on_gpio()
+#define SCHEDULER_MAX_GPIO_WAKES 4
+
+// Associação entre um pino e a tarefa que ele dispara
+typedef struct {
+    scheduler_t *scheduler;      // Escalonador da tarefa (NULL = posição livre)
+    int task;                    // Tarefa disparada
+    uint32_t gpio;               // Pino monitorado
+    uint32_t events;             // Bordas monitoradas
+} scheduler_gpio_wake_t;
+
+static scheduler_gpio_wake_t scheduler_gpio_wakes[SCHEDULER_MAX_GPIO_WAKES];
+
+// Verifica se o identificador corresponde a uma tarefa registrada
+static inline bool scheduler_valid_task(const scheduler_t *scheduler, int task) {
+    return task >= 0 && (uint32_t)task < scheduler->count;
+}
+
+// Inicializa um escalonador sem tarefas
+void scheduler_init(scheduler_t *scheduler) {
+    scheduler->count = 0;
+}
+
+// Registra uma tarefa
+int scheduler_add(scheduler_t *scheduler, scheduler_task_fn_t fn, void *context, uint32_t period_ms) {
+    if (scheduler->count >= SCHEDULER_MAX_TASKS) {
+        return SCHEDULER_ERROR_FULL;
+    }
+
+    scheduler_task_t *task = &scheduler->tasks[scheduler->count];
+    task->fn = fn;
+    task->context = context;
+    task->period_ms = period_ms;
+    task->deadline = period_ms == SCHEDULER_ON_DEMAND ? at_the_end_of_time : get_absolute_time();
+    task->triggered = false;
+
+    return (int)scheduler->count++;
+}
+
+// Altera o período de uma tarefa
+int scheduler_set_period(scheduler_t *scheduler, int task, uint32_t period_ms) {
+    if (!scheduler_valid_task(scheduler, task)) {
+        return SCHEDULER_ERROR_INVALID_TASK;
+    }
+
+    scheduler_task_t *t = &scheduler->tasks[task];
+    t->period_ms = period_ms;
+    t->deadline = period_ms == SCHEDULER_ON_DEMAND ? at_the_end_of_time : make_timeout_time_ms(period_ms);
+    return SCHEDULER_OK;
+}
+
+// Pede a execução imediata de uma tarefa
+void scheduler_trigger(scheduler_t *scheduler, int task) {
+    if (!scheduler_valid_task(scheduler, task)) {
+        return;
+    }
+    scheduler->tasks[task].triggered = true;
+    __sev(); // Acorda o núcleo do escalonador, caso esteja em WFE
+}
+
+// Tratador bruto de GPIO: converte bordas nos pinos associados em disparos de tarefa
+static void scheduler_gpio_handler(void) {
+    for (int i = 0; i < SCHEDULER_MAX_GPIO_WAKES; i++) {
+        scheduler_gpio_wake_t *wake = &scheduler_gpio_wakes[i];
+        if (wake->scheduler == NULL) {
+            continue;
+        }
+        uint32_t events = gpio_get_irq_event_mask(wake->gpio) & wake->events;
+        if (events) {
+            gpio_acknowledge_irq(wake->gpio, events);
+            scheduler_trigger(wake->scheduler, wake->task);
+        }
+    }
+}
+
+// Associa uma borda de um pino GPIO ao disparo de uma tarefa
+int scheduler_wake_on_gpio(scheduler_t *scheduler, int task, uint32_t gpio, uint32_t events) {
+    if (!scheduler_valid_task(scheduler, task)) {
+        return SCHEDULER_ERROR_INVALID_TASK;
+    }
+
+    for (int i = 0; i < SCHEDULER_MAX_GPIO_WAKES; i++) {
+        scheduler_gpio_wake_t *wake = &scheduler_gpio_wakes[i];
+        if (wake->scheduler != NULL) {
+            continue;
+        }
+        wake->scheduler = scheduler;
+        wake->task = task;
+        wake->gpio = gpio;
+        wake->events = events;
+
+        // A interrupção é habilitada no núcleo que chama esta função
+        gpio_add_raw_irq_handler(gpio, scheduler_gpio_handler);
+        gpio_set_irq_enabled(gpio, events, true);
+        irq_set_enabled(IO_IRQ_BANK0, true);
+        return SCHEDULER_OK;
+    }
+    return SCHEDULER_ERROR_FULL;
+}
+
+// Prazo mais próximo entre as tarefas
+absolute_time_t scheduler_next_deadline(const scheduler_t *scheduler) {
+    absolute_time_t next = at_the_end_of_time;
+
+    for (uint32_t i = 0; i < scheduler->count; i++) {
+        const scheduler_task_t *task = &scheduler->tasks[i];
+        if (task->triggered) {
+            return get_absolute_time();
+        }
+        if (absolute_time_diff_us(task->deadline, next) > 0) {
+            next = task->deadline;
+        }
+    }
+    return next;
+}
+
+// Executa as tarefas vencidas ou disparadas
+uint32_t scheduler_run_pending(scheduler_t *scheduler) {
+    uint32_t executed = 0;
+
+    for (uint32_t i = 0; i < scheduler->count; i++) {
+        scheduler_task_t *task = &scheduler->tasks[i];
+        bool due = task->period_ms != SCHEDULER_ON_DEMAND && time_reached(task->deadline);
+
+        if (!due && !task->triggered) {
+            continue;
+        }
+        task->triggered = false;
+
+        if (task->period_ms != SCHEDULER_ON_DEMAND) {
+            // Mantém a cadência; após um atraso longo, recomeça a partir de agora
+            task->deadline = delayed_by_ms(task->deadline, task->period_ms);
+            if (time_reached(task->deadline)) {
+                task->deadline = make_timeout_time_ms(task->period_ms);
+            }
+        }
+
+        task->fn(task->context);
+        executed++;
+    }
+
+    if (executed > 0) {
+        metrics_add(METRICS_TASK_RUNS, executed);
+    }
+    return executed;
+}
+
+// Laço principal do escalonador
+void scheduler_run(scheduler_t *scheduler) {
+    while (true) {
+        scheduler_run_pending(scheduler);
+
+        // Dorme até o próximo prazo; interrupções e SEV do outro núcleo
+        // também acordam o núcleo, e o laço reavalia as tarefas
+        uint32_t idle_start = time_us_32();
+        best_effort_wfe_or_timeout(scheduler_next_deadline(scheduler));
+        metrics_add_us(METRICS_IDLE_MS, time_us_32() - idle_start);
+    }
+}
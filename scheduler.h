@@ -0,0 +1,122 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "pico/time.h"
+
+// Códigos de retorno para as operações do escalonador
+#define SCHEDULER_OK 0                    // Operação bem-sucedida
+#define SCHEDULER_ERROR_FULL -1           // Número máximo de tarefas atingido
+#define SCHEDULER_ERROR_INVALID_TASK -2   // Identificador de tarefa inválido
+
+// Número máximo de tarefas por escalonador
+#define SCHEDULER_MAX_TASKS 8
+
+// Período que indica tarefa executada apenas sob demanda (scheduler_trigger)
+#define SCHEDULER_ON_DEMAND 0
+
+// Função executada quando uma tarefa vence
+typedef void (*scheduler_task_fn_t)(void *context);
+
+// Tarefa periódica ou sob demanda
+typedef struct {
+    scheduler_task_fn_t fn;      // Função da tarefa
+    void *context;               // Contexto repassado à função
+    uint32_t period_ms;          // Período (SCHEDULER_ON_DEMAND = sem período)
+    absolute_time_t deadline;    // Próximo horário de execução
+    volatile bool triggered;     // Execução pedida por evento (GPIO, outro núcleo)
+} scheduler_task_t;
+
+/**
+ * Escalonador orientado a eventos para um núcleo.
+ *
+ * Em vez de acordar em intervalos fixos, o escalonador calcula o prazo mais
+ * próximo entre todas as tarefas e dorme (WFE) até esse prazo ou até um
+ * evento externo, como uma interrupção de GPIO. Todas as tarefas rodam no
+ * núcleo que chama scheduler_run(); apenas scheduler_trigger() pode ser
+ * chamada de interrupções ou do outro núcleo.
+ */
+typedef struct {
+    scheduler_task_t tasks[SCHEDULER_MAX_TASKS];
+    uint32_t count;              // Tarefas registradas
+} scheduler_t;
+
+/**
+ * Inicializa um escalonador sem tarefas
+ *
+ * @param scheduler Escalonador a inicializar
+ */
+void scheduler_init(scheduler_t *scheduler);
+
+/**
+ * Registra uma tarefa
+ *
+ * A primeira execução de uma tarefa periódica ocorre imediatamente.
+ *
+ * @param scheduler Escalonador
+ * @param fn Função da tarefa
+ * @param context Contexto repassado à função
+ * @param period_ms Período em ms, ou SCHEDULER_ON_DEMAND
+ * @return Identificador da tarefa (>= 0) ou SCHEDULER_ERROR_FULL
+ */
+int scheduler_add(scheduler_t *scheduler, scheduler_task_fn_t fn, void *context, uint32_t period_ms);
+
+/**
+ * Altera o período de uma tarefa, a partir de agora
+ *
+ * @param scheduler Escalonador
+ * @param task Identificador retornado por scheduler_add()
+ * @param period_ms Novo período em ms, ou SCHEDULER_ON_DEMAND
+ * @return SCHEDULER_OK ou SCHEDULER_ERROR_INVALID_TASK
+ */
+int scheduler_set_period(scheduler_t *scheduler, int task, uint32_t period_ms);
+
+/**
+ * Pede a execução imediata de uma tarefa e acorda o núcleo do escalonador
+ *
+ * Segura para uso em interrupções e a partir do outro núcleo.
+ *
+ * @param scheduler Escalonador
+ * @param task Identificador retornado por scheduler_add()
+ */
+void scheduler_trigger(scheduler_t *scheduler, int task);
+
+/**
+ * Associa uma borda de um pino GPIO ao disparo de uma tarefa
+ *
+ * Permite acordar o escalonador por eventos externos (sensor de movimento,
+ * DOUT do HX711, botão) em vez de consultar o pino periodicamente. Usa o
+ * callback de GPIO compartilhado do SDK; vale uma associação por pino.
+ *
+ * @param scheduler Escalonador
+ * @param task Identificador retornado por scheduler_add()
+ * @param gpio Pino monitorado
+ * @param events Bordas (GPIO_IRQ_EDGE_FALL e/ou GPIO_IRQ_EDGE_RISE)
+ * @return SCHEDULER_OK, SCHEDULER_ERROR_FULL ou SCHEDULER_ERROR_INVALID_TASK
+ */
+int scheduler_wake_on_gpio(scheduler_t *scheduler, int task, uint32_t gpio, uint32_t events);
+
+/**
+ * @param scheduler Escalonador
+ * @return Prazo mais próximo entre as tarefas (at_the_end_of_time se nenhuma tiver prazo)
+ */
+absolute_time_t scheduler_next_deadline(const scheduler_t *scheduler);
+
+/**
+ * Executa as tarefas vencidas ou disparadas
+ *
+ * @param scheduler Escalonador
+ * @return Número de tarefas executadas
+ */
+uint32_t scheduler_run_pending(scheduler_t *scheduler);
+
+/**
+ * Laço principal: executa as tarefas pendentes e dorme até o próximo prazo
+ * ou evento. Não retorna.
+ *
+ * @param scheduler Escalonador
+ */
+void scheduler_run(scheduler_t *scheduler);
+
+#endif
@@ -1,14 +1,467 @@
 #include <stdio.h>
 #include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "pico/flash.h"
+#include "hardware/gpio.h"
+#include "calibration.h"
+#include "dht22.h"
+#include "flash_log.h"
+#include "hx711.h"
+#include "metrics.h"
+#include "power.h"
+#include "sample_queue.h"
+#include "sampling.h"
+#include "telemetry.h"
+#include "scheduler.h"
+#include "trace.h"
+#if SMART_BAG_UPLINK
+#include "uplink.h"
+#endif
+#include "weight_filter.h"
 
+// Pinos dos sensores
+#define HX711_DT_PIN 2
+#define HX711_SCK_PIN 3
+#define HX711_RATE_PIN 4
+#define DHT22_INSIDE_PIN 16
+#define DHT22_OUTSIDE_PIN 17
+#if SMART_BAG_DHT22_SUPPLY_PIN
+#define DHT22_SUPPLY_PIN 18            // Alimentação chaveada dos DHT22 (opção SMART_BAG_DHT22_SUPPLY_PIN)
+#endif
 
+// Parâmetros da aquisição (núcleo 1)
+#define HX711_STREAM_CAPACITY 64       // Amostras no anel do DMA (0,8 s a 80 SPS)
+#define HX711_BATCH_SIZE 16            // Amostras retiradas do anel por vez
+#define WEIGHT_DRAIN_PERIOD_MS 400     // Meio anel a 80 SPS: retira antes de transbordar
+#define WEIGHT_IDLE_PERIOD_MS 1000     // Leitura isolada do HX711 em repouso
+#define WEIGHT_TRIGGER_THRESHOLD 1000  // Variação que passa à taxa plena (contagens)
+#define WEIGHT_ACTIVE_HOLD_MS 10000    // Tempo sem variação antes de voltar ao repouso
+#define ENVIRONMENT_MAX_INTERVAL_MS 64000 // Intervalo dos DHT22 com valores estáveis
+#define ENVIRONMENT_TOLERANCE_X10 2    // Variação tolerada: 0,2 °C e 0,2 %
+
+// Parâmetros do processamento (núcleo 0)
+#define SAMPLE_POP_BATCH 16            // Amostras retiradas da fila por vez
+#define WEIGHT_FILTER_WINDOW 5         // Janela da mediana
+#define WEIGHT_SETTLE_TOLERANCE 200    // Variação aceita para peso estável (contagens)
+#define WEIGHT_SETTLE_SAMPLES 8        // Estimativas consecutivas dentro da tolerância
+#define REPORT_INTERVAL_MS 1000        // Intervalo entre registros com o peso mudando
+#define REPORT_IDLE_INTERVAL_MS 10000  // Intervalo entre registros com o peso estável
+#define TELEMETRY_BATCH_RECORDS 20     // Registros por lote enviado (ou até encher uma página do log)
+#define TELEMETRY_BATCH_BYTES FLASH_LOG_PAGE_PAYLOAD // Cada lote ocupa uma página do log na flash
+#define LOG_FLUSH_INTERVAL_MS (2 * 60 * 1000) // Dados ainda em RAM (lote e páginas) perdidos num reset
+#define TRACE_DUMP_COMMAND 't'         // Caractere recebido pela stdio que imprime o rastreamento
+#define TARE_COMMAND 'z'               // Caractere recebido pela stdio que grava a tara atual
+#define CALIBRATE_COMMAND 'c'          // Caractere recebido pela stdio que calibra com o peso de referência
+#define CALIBRATION_WEIGHT_G 1000.0f   // Peso de referência sobre a balança ao enviar CALIBRATE_COMMAND
+#define METRICS_COMMAND 'm'            // Caractere recebido pela stdio que envia o retrato das métricas
+
+// Parâmetros do uplink Wi-Fi (núcleo 0); rede e receptor vêm do CMake, que só
+// define SMART_BAG_UPLINK com um SSID configurado
+#define UPLINK_INTERVAL_MS (10 * 60 * 1000) // Lotes acumulados entre acordares do rádio
+#define UPLINK_MAX_RECORDS 64          // Lotes enviados por conexão
+#define UPLINK_CONNECT_TIMEOUT_MS 15000 // Associação e DHCP
+
+// Identificadores dos sensores (campo source de sample_t)
+typedef enum {
+    SOURCE_WEIGHT,               // HX711 da célula de carga
+    SOURCE_DHT22_INSIDE,         // DHT22 dentro da bolsa
+    SOURCE_DHT22_OUTSIDE         // DHT22 fora da bolsa
+} sample_source_t;
+
+// Fila entre o núcleo 1 (produtor) e o núcleo 0 (consumidor)
+static sample_queue_t sample_queue;
+
+// Anel preenchido pelo DMA com as conversões do HX711
+static HX711_STREAM_BUFFER(hx711_ring, HX711_STREAM_CAPACITY);
+
+// Sensores DHT22 (um dentro e outro fora da bolsa)
+static dht22_t dht22_inside;
+static dht22_t dht22_outside;
+
+// Escalonador da aquisição (núcleo 1)
+static scheduler_t acquisition_scheduler;
+static int weight_task;
+static int environment_task;
+static int environment_publish_task;
+
+// Taxas de aquisição adaptativas (núcleo 1)
+static sampling_weight_t weight_trigger;
+static sampling_env_t environment_policy;
+
+// Alimentação dos sensores, ligada só o aquecimento antes de cada leitura (núcleo 1)
+static power_t sensor_power;
+static int hx711_rail;
+static int dht22_rail;
+
+#if SMART_BAG_UPLINK
+// Rede e receptor dos lotes de telemetria
+static const uplink_config_t uplink_config = {
+    .ssid = SMART_BAG_WIFI_SSID,
+    .password = SMART_BAG_WIFI_PASSWORD,
+    .host = SMART_BAG_UPLINK_HOST,
+    .port = SMART_BAG_UPLINK_PORT,
+    .connect_timeout_ms = UPLINK_CONNECT_TIMEOUT_MS,
+};
+#endif
+
+// Envia amostras ao núcleo 0 e o acorda; com a fila cheia, o excesso é descartado
+static void publish_samples(const sample_t *samples, uint32_t count) {
+    sample_queue_push_batch(&sample_queue, samples, count);
+    __sev();
+}
+
+// Guarda um lote de telemetria no log da flash e o envia pela stdio
+static void publish_telemetry(const uint8_t *batch, uint32_t length) {
+    flash_log_append(batch, length);
+    fwrite(batch, 1, length, stdout);
+    fflush(stdout);
+}
+
+// Grava a tara e a escala atuais para as próximas partidas
+static void persist_calibration(calibration_t *calibration) {
+    calibration_capture(calibration);
+    calibration_save(calibration);
+    flash_log_flush(); // A telemetria anterior à calibração também fica gravada
+}
+
+// Alimentação do HX711: power-down pelo SCK
+static void switch_hx711_power(void *context, bool on) {
+    (void)context;
+    if (on) {
+        hx711_power_up();
+    } else {
+        hx711_power_down();
+    }
+}
+
+#ifdef DHT22_SUPPLY_PIN
+// Alimentação dos DHT22: o pull-up das linhas de dados segue o pino de alimentação
+static void switch_dht22_power(void *context, bool on) {
+    (void)context;
+    if (!on) {
+        dht22_set_powered(&dht22_inside, false);
+        dht22_set_powered(&dht22_outside, false);
+    }
+    gpio_put(DHT22_SUPPLY_PIN, on);
+    if (on) {
+        dht22_set_powered(&dht22_inside, true);
+        dht22_set_powered(&dht22_outside, true);
+    }
+}
+#endif
+
+// Leituras dos DHT22 em andamento (núcleo 1)
+static dht22_t *const environment_sensors[] = {&dht22_inside, &dht22_outside};
+static int environment_start_result[count_of(environment_sensors)];
+
+// Fim de uma leitura assíncrona (interrupção do alarme): acorda a tarefa que publica
+static void environment_read_done(int result, float temperature, float humidity, void *user_data) {
+    (void)result;
+    (void)temperature;
+    (void)humidity;
+    (void)user_data;
+    scheduler_trigger(&acquisition_scheduler, environment_publish_task);
+}
+
+// Tarefa: dispara as leituras dos dois DHT22 sem bloquear o núcleo
+static void acquire_environment(void *context) {
+    (void)context;
+
+    // Sensores recém-ligados: volta quando o aquecimento terminar
+    uint32_t warmup_ms = power_acquire(&sensor_power, dht22_rail);
+    if (warmup_ms > 0) {
+        scheduler_set_period(&acquisition_scheduler, environment_task, warmup_ms);
+        return;
+    }
+
+    // O quadro, as novas tentativas e o backoff correm nos alarmes; enquanto
+    // isso o escalonador segue atendendo o HX711. A próxima rodada é agendada
+    // por publish_environment().
+    scheduler_set_period(&acquisition_scheduler, environment_task, SCHEDULER_ON_DEMAND);
+    for (size_t i = 0; i < count_of(environment_sensors); i++) {
+        environment_start_result[i] = dht22_read_async(environment_sensors[i], environment_read_done, NULL);
+    }
+    scheduler_trigger(&acquisition_scheduler, environment_publish_task); // Cobre leituras que nem começaram
+}
+
+// Tarefa sob demanda: publica quando as duas leituras terminaram
+static void publish_environment(void *context) {
+    (void)context;
+    const sample_source_t sources[] = {SOURCE_DHT22_INSIDE, SOURCE_DHT22_OUTSIDE};
+    sample_t samples[count_of(environment_sensors)] = {0};
+
+    for (size_t i = 0; i < count_of(environment_sensors); i++) {
+        if (environment_start_result[i] == DHT22_OK && !dht22_read_ready(environment_sensors[i])) {
+            return; // O callback da outra leitura dispara esta tarefa de novo
+        }
+    }
+
+    for (size_t i = 0; i < count_of(environment_sensors); i++) {
+        samples[i].timestamp_us = time_us_32();
+        samples[i].kind = SAMPLE_KIND_DHT22;
+        samples[i].source = sources[i];
+        samples[i].status = environment_start_result[i] != DHT22_OK
+                                ? environment_start_result[i]
+                                : dht22_get_result_x10(environment_sensors[i], &samples[i].dht22.temperature_x10,
+                                                       &samples[i].dht22.humidity_x10);
+        sampling_env_observe(&environment_policy, i, samples[i].status == DHT22_OK,
+                             samples[i].dht22.temperature_x10, samples[i].dht22.humidity_x10);
+    }
+    publish_samples(samples, count_of(samples));
+
+    // Valores estáveis espaçam as leituras; qualquer mudança volta ao intervalo mínimo.
+    // Entre leituras os sensores ficam desligados, exceto pelo aquecimento.
+    uint32_t interval_ms = sampling_env_next_interval(&environment_policy);
+    scheduler_set_period(&acquisition_scheduler, environment_task, power_release(&sensor_power, dht22_rail, interval_ms));
+}
+
+// Preenche uma amostra de peso
+static void fill_weight_sample(sample_t *sample, uint32_t timestamp_us, int32_t raw) {
+    sample->timestamp_us = timestamp_us;
+    sample->kind = SAMPLE_KIND_HX711;
+    sample->source = SOURCE_WEIGHT;
+    sample->status = HX711_OK;
+    sample->hx711_raw = raw;
+}
+
+// Tarefa: em repouso, uma leitura isolada do HX711; em atividade, retira do
+// anel as conversões acumuladas e as publica em lote
+static void acquire_weight(void *context) {
+    (void)context;
+    int32_t batch[HX711_BATCH_SIZE];
+    sample_t samples[HX711_BATCH_SIZE];
+    uint32_t count;
+
+    if (weight_trigger.mode == SAMPLING_IDLE) {
+        // HX711 saindo do power-down: volta quando a acomodação terminar
+        uint32_t warmup_ms = power_acquire(&sensor_power, hx711_rail);
+        if (warmup_ms > 0) {
+            scheduler_set_period(&acquisition_scheduler, weight_task, warmup_ms);
+            return;
+        }
+
+        int32_t raw = hx711_read(HX711_DT_PIN, HX711_SCK_PIN);
+        if (raw == HX711_READ_ERROR) {
+            scheduler_set_period(&acquisition_scheduler, weight_task, WEIGHT_IDLE_PERIOD_MS);
+            return;
+        }
+        fill_weight_sample(&samples[0], time_us_32(), raw);
+        publish_samples(samples, 1);
+
+        // Objeto colocado ou retirado: taxa plena pelo PIO + DMA
+        if (sampling_weight_update(&weight_trigger, raw, to_ms_since_boot(get_absolute_time())) == SAMPLING_ACTIVE) {
+            hx711_stream_start(hx711_ring, HX711_STREAM_CAPACITY);
+            hx711_set_rate(HX711_RATE_80SPS);
+            scheduler_set_period(&acquisition_scheduler, weight_task, WEIGHT_DRAIN_PERIOD_MS);
+            return;
+        }
+
+        // Em repouso, o HX711 fica em power-down entre as leituras isoladas
+        scheduler_set_period(&acquisition_scheduler, weight_task,
+                             power_release(&sensor_power, hx711_rail, WEIGHT_IDLE_PERIOD_MS));
+        return;
+    }
+
+    while ((count = hx711_stream_read(batch, HX711_BATCH_SIZE)) > 0) {
+        uint32_t now = time_us_32();
+        uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+        for (uint32_t i = 0; i < count; i++) {
+            fill_weight_sample(&samples[i], now, batch[i]);
+            sampling_weight_update(&weight_trigger, batch[i], now_ms);
+        }
+        publish_samples(samples, count);
+    }
+
+    // Peso parado por WEIGHT_ACTIVE_HOLD_MS: volta às leituras isoladas
+    if (weight_trigger.mode == SAMPLING_IDLE) {
+        hx711_stream_stop();
+        hx711_set_rate(HX711_RATE_10SPS); // Menos ruído nas leituras isoladas
+        scheduler_set_period(&acquisition_scheduler, weight_task,
+                             power_release(&sensor_power, hx711_rail, WEIGHT_IDLE_PERIOD_MS));
+    }
+}
+
+// Núcleo 1: aquisição dos sensores, isolada do processamento e da rede
+static void core1_entry(void) {
+    trace_init();
+    flash_safe_execute_core_init(); // Permite ao núcleo 0 pausar este núcleo durante gravações na flash
+    hx711_set_rate_pin(HX711_RATE_PIN); // Repouso a 10 SPS
+    hx711_init(HX711_DT_PIN, HX711_SCK_PIN);
+#ifdef DHT22_SUPPLY_PIN
+    gpio_init(DHT22_SUPPLY_PIN);
+    gpio_put(DHT22_SUPPLY_PIN, 1);
+    gpio_set_dir(DHT22_SUPPLY_PIN, GPIO_OUT);
+#endif
+    dht22_init(&dht22_inside, DHT22_INSIDE_PIN, DHT22_CAPTURE_PIO);
+    dht22_init(&dht22_outside, DHT22_OUTSIDE_PIN, DHT22_CAPTURE_PIO);
+
+    // Cada sensor é ligado só o seu tempo de aquecimento antes de ser lido
+    power_init(&sensor_power);
+    hx711_rail = power_add_rail(&sensor_power, switch_hx711_power, NULL, HX711_POWER_UP_MS, METRICS_HX711_ON_MS);
+#ifdef DHT22_SUPPLY_PIN
+    dht22_rail = power_add_rail(&sensor_power, switch_dht22_power, NULL, DHT22_POWER_UP_MS, METRICS_DHT22_ON_MS);
+#else
+    dht22_rail = power_add_rail(&sensor_power, NULL, NULL, 0, METRICS_DHT22_ON_MS); // Sempre ligados: só o tempo
+#endif
+
+    // A aquisição começa em repouso e acelera quando o peso ou o ambiente mudam
+    sampling_weight_init(&weight_trigger, WEIGHT_TRIGGER_THRESHOLD, WEIGHT_ACTIVE_HOLD_MS);
+    sampling_env_init(&environment_policy, DHT22_MIN_INTERVAL_MS, ENVIRONMENT_MAX_INTERVAL_MS, ENVIRONMENT_TOLERANCE_X10);
+
+    // Cada sensor tem seu próprio prazo; entre prazos o núcleo dorme em WFE
+    scheduler_init(&acquisition_scheduler);
+    weight_task = scheduler_add(&acquisition_scheduler, acquire_weight, NULL, WEIGHT_IDLE_PERIOD_MS);
+    environment_task = scheduler_add(&acquisition_scheduler, acquire_environment, NULL, DHT22_MIN_INTERVAL_MS);
+    environment_publish_task = scheduler_add(&acquisition_scheduler, publish_environment, NULL, SCHEDULER_ON_DEMAND);
+    scheduler_run(&acquisition_scheduler);
+}
 
 int main()
 {
     stdio_init_all();
+    trace_init();
+
+    // Calibração gravada: o primeiro peso já sai calibrado, sem refazer a tara
+    static calibration_t calibration;
+    if (calibration_load(&calibration) == CALIBRATION_OK) {
+        calibration_apply(&calibration);
+    }
+
+    sample_queue_init(&sample_queue);
+    multicore_launch_core1(core1_entry);
+    flash_log_init();
+
+    // Núcleo 0: filtragem, detecção de estabilidade e relatórios
+    weight_filter_t weight_filter;
+    weight_settle_t weight_settle;
+    weight_filter_init(&weight_filter, WEIGHT_FILTER_MEDIAN, WEIGHT_FILTER_WINDOW);
+    weight_settle_init(&weight_settle, WEIGHT_SETTLE_TOLERANCE, WEIGHT_SETTLE_SAMPLES);
+
+    sample_t inside = {0};
+    sample_t outside = {0};
+    uint32_t last_report_ms = 0;
+    uint32_t last_flush_ms = 0;
+#if SMART_BAG_UPLINK
+    uint32_t next_uplink_ms = UPLINK_INTERVAL_MS;
+#endif
+    uint32_t reported_drops = 0;
+    bool weight_valid = false;
+    
+    static uint8_t telemetry_batch[TELEMETRY_BATCH_BYTES];
+    telemetry_encoder_t telemetry;
+    telemetry_encoder_init(&telemetry, telemetry_batch, sizeof(telemetry_batch));
 
     while (true) {
-        printf("Hello, world!\n");
-        sleep_ms(1000);
+        sample_t samples[SAMPLE_POP_BATCH];
+        uint32_t count = sample_queue_pop_batch(&sample_queue, samples, SAMPLE_POP_BATCH);
+        if (count == 0) {
+            uint32_t idle_start = time_us_32();
+            __wfe(); // Dorme até o núcleo 1 publicar novas amostras
+            metrics_add_us(METRICS_IDLE_MS, time_us_32() - idle_start);
+            continue;
+        }
+
+        for (uint32_t i = 0; i < count; i++) {
+            const sample_t *sample = &samples[i];
+            switch (sample->source) {
+            case SOURCE_WEIGHT:
+                weight_settle_update(&weight_settle, weight_filter_update(&weight_filter, sample->hx711_raw));
+                weight_valid = true;
+                break;
+            case SOURCE_DHT22_INSIDE:
+                inside = *sample;
+                break;
+            case SOURCE_DHT22_OUTSIDE:
+                outside = *sample;
+                break;
+            }
+        }
+
+        uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+        uint32_t report_interval_ms = weight_settle.stable ? REPORT_IDLE_INTERVAL_MS : REPORT_INTERVAL_MS;
+        if (now_ms - last_report_ms >= report_interval_ms) {
+            last_report_ms = now_ms;
+            
+            // Registro binário: nenhum valor é formatado como texto
+            uint32_t drops = sample_queue_dropped(&sample_queue);
+            telemetry_record_t record = {
+                .timestamp_ms = now_ms,
+                .weight_mg = calculate_weight_mg(weight_filter_value(&weight_filter)),
+                .inside_temperature_x10 = inside.dht22.temperature_x10,
+                .inside_humidity_x10 = inside.dht22.humidity_x10,
+                .outside_temperature_x10 = outside.dht22.temperature_x10,
+                .outside_humidity_x10 = outside.dht22.humidity_x10,
+                .status = (weight_valid ? TELEMETRY_STATUS_WEIGHT_VALID : 0) |
+                          (weight_settle.stable ? TELEMETRY_STATUS_WEIGHT_STABLE : 0) |
+                          (inside.kind == SAMPLE_KIND_DHT22 && inside.status == DHT22_OK ? TELEMETRY_STATUS_INSIDE_VALID : 0) |
+                          (outside.kind == SAMPLE_KIND_DHT22 && outside.status == DHT22_OK ? TELEMETRY_STATUS_OUTSIDE_VALID : 0) |
+                          (drops != reported_drops ? TELEMETRY_STATUS_DROPPED : 0),
+            };
+            reported_drops = drops;
+
+            // Medidores da fila e do log, escritos só por este núcleo
+            metrics_max(METRICS_QUEUE_HIGH_WATER, sample_queue_high_water(&sample_queue));
+            metrics_set(METRICS_SAMPLES_DROPPED, drops);
+            metrics_set(METRICS_LOG_PENDING, flash_log_pending());
+            
+            // Lote cheio: publica e recomeça com o registro que não coube
+            if (!telemetry_encoder_add(&telemetry, &record)) {
+                publish_telemetry(telemetry_batch, telemetry_encoder_finish(&telemetry));
+                telemetry_encoder_init(&telemetry, telemetry_batch, sizeof(telemetry_batch));
+                telemetry_encoder_add(&telemetry, &record);
+            }
+            if (telemetry.count >= TELEMETRY_BATCH_RECORDS) {
+                publish_telemetry(telemetry_batch, telemetry_encoder_finish(&telemetry));
+                telemetry_encoder_init(&telemetry, telemetry_batch, sizeof(telemetry_batch));
+            }
+
+            // Com o peso parado, um lote demora minutos para encher: periodicamente
+            // o lote parcial e as páginas em RAM vão para a flash
+            if (now_ms - last_flush_ms >= LOG_FLUSH_INTERVAL_MS) {
+                last_flush_ms = now_ms;
+                if (telemetry.count > 0) {
+                    publish_telemetry(telemetry_batch, telemetry_encoder_finish(&telemetry));
+                    telemetry_encoder_init(&telemetry, telemetry_batch, sizeof(telemetry_batch));
+                }
+                flash_log_flush();
+            }
+
+#if SMART_BAG_UPLINK
+            // Rádio ligado só a cada UPLINK_INTERVAL_MS; durante a conexão a fila
+            // pode transbordar, o que aparece como TELEMETRY_STATUS_DROPPED
+            if ((int32_t)(now_ms - next_uplink_ms) >= 0) {
+                uint32_t sent;
+                uplink_send_log(&uplink_config, UPLINK_MAX_RECORDS, &sent);
+                next_uplink_ms = to_ms_since_boot(get_absolute_time()) + UPLINK_INTERVAL_MS;
+            }
+#endif
+            
+            int command = getchar_timeout_us(0);
+#if SMART_BAG_TRACE
+            if (command == TRACE_DUMP_COMMAND) {
+                trace_dump();
+            }
+#endif
+            // Retrato binário das métricas, no mesmo canal dos lotes de telemetria
+            if (command == METRICS_COMMAND) {
+                metrics_snapshot_t snapshot;
+                uint8_t encoded[TELEMETRY_METRICS_MAX_ENCODED];
+                metrics_snapshot(&snapshot);
+                fwrite(encoded, 1, telemetry_encode_metrics(&snapshot, encoded, sizeof(encoded)), stdout);
+                fflush(stdout);
+            }
+            // Tara e calibração só com o peso assentado; com a bolsa balançando nada é gravado
+            if ((command == TARE_COMMAND || command == CALIBRATE_COMMAND) && !weight_settle.stable) {
+                printf("instável\n");
+            } else if (command == TARE_COMMAND) {
+                // Tara com o peso atual, gravada para as próximas partidas
+                tare_hx711(weight_settle_value(&weight_settle));
+                persist_calibration(&calibration);
+            } else if (command == CALIBRATE_COMMAND) {
+                // Escala a partir do peso de referência, após a tara com a balança vazia
+                calibrate_hx711(weight_settle_value(&weight_settle), CALIBRATION_WEIGHT_G);
+                persist_calibration(&calibration);
+            }
+        }
     }
 }
@@ -0,0 +1,194 @@
+#include "telemetry.h"
+#include <string.h>
+
+// Zigzag: intercala positivos e negativos para que diferenças pequenas usem poucos bytes
+static inline uint32_t telemetry_zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t telemetry_unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// Escreve um varint (7 bits por byte, bit 7 = continua) e retorna o próximo byte livre
+static inline uint8_t *telemetry_put_varint(uint8_t *out, uint32_t value) {
+    while (value >= 0x80) {
+        *out++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (uint8_t)value;
+    return out;
+}
+
+// Lê um varint; retorna NULL se o lote terminar no meio do valor
+static const uint8_t *telemetry_get_varint(const uint8_t *in, const uint8_t *end, uint32_t *value) {
+    uint32_t result = 0;
+
+    for (uint32_t shift = 0; shift < 35; shift += 7) {
+        if (in >= end) {
+            return NULL;
+        }
+        uint8_t byte = *in++;
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            *value = result;
+            return in;
+        }
+    }
+    return NULL;
+}
+
+// Inicia um lote vazio
+void telemetry_encoder_init(telemetry_encoder_t *encoder, uint8_t *buffer, uint32_t capacity) {
+    encoder->buffer = buffer;
+    encoder->capacity = capacity;
+    encoder->length = TELEMETRY_HEADER_SIZE;
+    encoder->count = 0;
+    memset(&encoder->previous, 0, sizeof(encoder->previous));
+}
+
+// Acrescenta um registro, codificado como diferenças para o anterior
+bool telemetry_encoder_add(telemetry_encoder_t *encoder, const telemetry_record_t *record) {
+    const telemetry_record_t *prev = &encoder->previous;
+    uint8_t scratch[TELEMETRY_RECORD_MAX_ENCODED];
+    uint8_t *out = scratch;
+
+    if (encoder->count >= TELEMETRY_MAX_RECORDS) {
+        return false;
+    }
+
+    out = telemetry_put_varint(out, record->timestamp_ms - prev->timestamp_ms);
+    out = telemetry_put_varint(out, telemetry_zigzag((int32_t)((uint32_t)record->weight_mg - (uint32_t)prev->weight_mg)));
+    out = telemetry_put_varint(out, telemetry_zigzag(record->inside_temperature_x10 - prev->inside_temperature_x10));
+    out = telemetry_put_varint(out, telemetry_zigzag(record->inside_humidity_x10 - prev->inside_humidity_x10));
+    out = telemetry_put_varint(out, telemetry_zigzag(record->outside_temperature_x10 - prev->outside_temperature_x10));
+    out = telemetry_put_varint(out, telemetry_zigzag(record->outside_humidity_x10 - prev->outside_humidity_x10));
+    out = telemetry_put_varint(out, record->status ^ prev->status);
+
+    uint32_t size = (uint32_t)(out - scratch);
+    if (encoder->length + size > encoder->capacity) {
+        return false;
+    }
+
+    memcpy(&encoder->buffer[encoder->length], scratch, size);
+    encoder->length += size;
+    encoder->count++;
+    encoder->previous = *record;
+    return true;
+}
+
+// Escreve o cabeçalho e retorna o tamanho do lote
+uint32_t telemetry_encoder_finish(telemetry_encoder_t *encoder) {
+    encoder->buffer[0] = TELEMETRY_MAGIC0;
+    encoder->buffer[1] = TELEMETRY_MAGIC1;
+    encoder->buffer[2] = TELEMETRY_VERSION;
+    encoder->buffer[3] = (uint8_t)encoder->count;
+    return encoder->length;
+}
+
+// Decodifica um lote, aplicando as diferenças na ordem em que foram escritas
+int telemetry_decode(const uint8_t *buffer, uint32_t length, telemetry_record_t *records, uint32_t max_records,
+                     uint32_t *count) {
+    const uint8_t *in = buffer + TELEMETRY_HEADER_SIZE;
+    const uint8_t *end = buffer + length;
+    telemetry_record_t current;
+    uint32_t fields[7];
+
+    if (length < TELEMETRY_HEADER_SIZE || buffer[0] != TELEMETRY_MAGIC0 || buffer[1] != TELEMETRY_MAGIC1 ||
+        buffer[2] != TELEMETRY_VERSION) {
+        return TELEMETRY_ERROR_FORMAT;
+    }
+    if (buffer[3] > max_records) {
+        return TELEMETRY_ERROR_SPACE;
+    }
+
+    memset(&current, 0, sizeof(current));
+    for (uint32_t i = 0; i < buffer[3]; i++) {
+        for (uint32_t f = 0; f < 7; f++) {
+            in = telemetry_get_varint(in, end, &fields[f]);
+            if (in == NULL) {
+                return TELEMETRY_ERROR_FORMAT;
+            }
+        }
+
+        current.timestamp_ms += fields[0];
+        current.weight_mg = (int32_t)((uint32_t)current.weight_mg + (uint32_t)telemetry_unzigzag(fields[1]));
+        current.inside_temperature_x10 = (int16_t)(current.inside_temperature_x10 + telemetry_unzigzag(fields[2]));
+        current.inside_humidity_x10 = (uint16_t)(current.inside_humidity_x10 + telemetry_unzigzag(fields[3]));
+        current.outside_temperature_x10 = (int16_t)(current.outside_temperature_x10 + telemetry_unzigzag(fields[4]));
+        current.outside_humidity_x10 = (uint16_t)(current.outside_humidity_x10 + telemetry_unzigzag(fields[5]));
+        current.status = (uint16_t)(current.status ^ fields[6]);
+        records[i] = current;
+    }
+
+    *count = buffer[3];
+    return TELEMETRY_OK;
+}
+
+// Codifica um retrato de métricas
+uint32_t telemetry_encode_metrics(const metrics_snapshot_t *snapshot, uint8_t *buffer, uint32_t capacity) {
+    uint8_t scratch[TELEMETRY_METRICS_MAX_ENCODED];
+    uint8_t *out = scratch + TELEMETRY_HEADER_SIZE;
+
+    scratch[0] = TELEMETRY_MAGIC0;
+    scratch[1] = TELEMETRY_METRICS_MAGIC1;
+    scratch[2] = TELEMETRY_METRICS_VERSION;
+    scratch[3] = METRICS_COUNTER_COUNT;
+
+    out = telemetry_put_varint(out, snapshot->uptime_ms);
+    for (uint32_t core = 0; core < METRICS_CORES; core++) {
+        out = telemetry_put_varint(out, snapshot->idle_ms[core]);
+    }
+    out = telemetry_put_varint(out, snapshot->charge_uah);
+    for (uint32_t c = 0; c < METRICS_COUNTER_COUNT; c++) {
+        out = telemetry_put_varint(out, snapshot->counters[c]);
+    }
+
+    uint32_t size = (uint32_t)(out - scratch);
+    if (size > capacity) {
+        return 0;
+    }
+    memcpy(buffer, scratch, size);
+    return size;
+}
+
+// Decodifica um retrato de métricas
+int telemetry_decode_metrics(const uint8_t *buffer, uint32_t length, metrics_snapshot_t *snapshot) {
+    const uint8_t *in = buffer + TELEMETRY_HEADER_SIZE;
+    const uint8_t *end = buffer + length;
+    uint32_t value;
+
+    if (length < TELEMETRY_HEADER_SIZE || buffer[0] != TELEMETRY_MAGIC0 || buffer[1] != TELEMETRY_METRICS_MAGIC1 ||
+        buffer[2] != TELEMETRY_METRICS_VERSION) {
+        return TELEMETRY_ERROR_FORMAT;
+    }
+
+    memset(snapshot, 0, sizeof(*snapshot));
+    if ((in = telemetry_get_varint(in, end, &snapshot->uptime_ms)) == NULL) {
+        return TELEMETRY_ERROR_FORMAT;
+    }
+    for (uint32_t core = 0; core < METRICS_CORES; core++) {
+        if ((in = telemetry_get_varint(in, end, &snapshot->idle_ms[core])) == NULL) {
+            return TELEMETRY_ERROR_FORMAT;
+        }
+    }
+    if ((in = telemetry_get_varint(in, end, &snapshot->charge_uah)) == NULL) {
+        return TELEMETRY_ERROR_FORMAT;
+    }
+    for (uint32_t c = 0; c < buffer[3]; c++) {
+        if ((in = telemetry_get_varint(in, end, &value)) == NULL) {
+            return TELEMETRY_ERROR_FORMAT;
+        }
+        if (c < METRICS_COUNTER_COUNT) {
+            snapshot->counters[c] = value;
+        }
+    }
+
+    for (uint32_t core = 0; core < METRICS_CORES; core++) {
+        uint32_t idle = snapshot->idle_ms[core];
+        uint32_t busy = snapshot->uptime_ms > idle ? snapshot->uptime_ms - idle : 0;
+        snapshot->busy_permille[core] =
+            snapshot->uptime_ms ? (uint32_t)((uint64_t)busy * 1000 / snapshot->uptime_ms) : 0;
+    }
+    return TELEMETRY_OK;
+}
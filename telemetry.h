@@ -0,0 +1,144 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "metrics.h"
+
+// Códigos de retorno da decodificação
+#define TELEMETRY_OK 0                    // Lote decodificado
+#define TELEMETRY_ERROR_FORMAT -1         // Cabeçalho inválido ou lote truncado
+#define TELEMETRY_ERROR_SPACE -2          // Destino menor que o número de registros
+
+// Cabeçalho do lote: 'S', 'B', versão, número de registros
+#define TELEMETRY_MAGIC0 'S'
+#define TELEMETRY_MAGIC1 'B'
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_HEADER_SIZE 4
+
+// Cabeçalho do retrato de métricas: 'S', 'M', versão, número de contadores
+#define TELEMETRY_METRICS_MAGIC1 'M'
+#define TELEMETRY_METRICS_VERSION 1
+
+// Pior caso do retrato de métricas: horário, ociosidade de cada núcleo, carga e contadores
+#define TELEMETRY_METRICS_FIELDS (2 + METRICS_CORES + METRICS_COUNTER_COUNT)
+#define TELEMETRY_METRICS_MAX_ENCODED (TELEMETRY_HEADER_SIZE + 5 * TELEMETRY_METRICS_FIELDS)
+
+// Pior caso de um registro codificado (varints de 32 e 16 bits)
+#define TELEMETRY_RECORD_MAX_ENCODED 25
+
+// Registros por lote (limitado pelo contador de 8 bits do cabeçalho)
+#define TELEMETRY_MAX_RECORDS 255
+
+// Bits de status do registro
+#define TELEMETRY_STATUS_WEIGHT_VALID (1u << 0)   // Peso calculado a partir de amostras
+#define TELEMETRY_STATUS_WEIGHT_STABLE (1u << 1)  // Detector de estabilidade satisfeito
+#define TELEMETRY_STATUS_INSIDE_VALID (1u << 2)   // Última leitura do DHT22 interno válida
+#define TELEMETRY_STATUS_OUTSIDE_VALID (1u << 3)  // Última leitura do DHT22 externo válida
+#define TELEMETRY_STATUS_DROPPED (1u << 4)        // Amostras descartadas desde o registro anterior
+
+/**
+ * Registro de telemetria com valores inteiros, sem formatação de texto.
+ *
+ * Temperatura e umidade vêm dos campos em décimos produzidos pelo driver
+ * DHT22; o peso vem da conversão em ponto fixo do HX711. Em memória o
+ * registro ocupa 22 bytes; no lote, cada campo é codificado como a
+ * diferença para o registro anterior.
+ */
+typedef struct __attribute__((packed)) {
+    uint32_t timestamp_ms;       // Horário do registro (ms desde a partida)
+    int32_t weight_mg;           // Peso filtrado em mg
+    int16_t inside_temperature_x10;  // DHT22 interno: décimos de °C
+    uint16_t inside_humidity_x10;    // DHT22 interno: décimos de %
+    int16_t outside_temperature_x10; // DHT22 externo: décimos de °C
+    uint16_t outside_humidity_x10;   // DHT22 externo: décimos de %
+    uint16_t status;             // TELEMETRY_STATUS_*
+} telemetry_record_t;
+
+/**
+ * Codificador de lotes.
+ *
+ * Formato: cabeçalho de TELEMETRY_HEADER_SIZE bytes seguido dos registros.
+ * Cada campo é a diferença para o mesmo campo do registro anterior (o
+ * primeiro registro é comparado com zeros): o horário como varint sem
+ * sinal, os bits de status como XOR com o anterior e os demais campos
+ * como varint zigzag. Registros consecutivos costumam custar 8 a 12
+ * bytes, contra ~100 bytes do relatório em texto.
+ */
+typedef struct {
+    uint8_t *buffer;             // Destino do lote
+    uint32_t capacity;           // Tamanho do destino em bytes
+    uint32_t length;             // Bytes já escritos
+    uint32_t count;              // Registros no lote
+    telemetry_record_t previous; // Base das diferenças
+} telemetry_encoder_t;
+
+/**
+ * Inicia um lote vazio
+ *
+ * @param encoder Codificador
+ * @param buffer Destino do lote
+ * @param capacity Tamanho do destino (>= TELEMETRY_HEADER_SIZE)
+ */
+void telemetry_encoder_init(telemetry_encoder_t *encoder, uint8_t *buffer, uint32_t capacity);
+
+/**
+ * Acrescenta um registro ao lote
+ *
+ * @param encoder Codificador
+ * @param record Registro
+ * @return true se coube; false se o lote está cheio (o registro não é escrito)
+ */
+bool telemetry_encoder_add(telemetry_encoder_t *encoder, const telemetry_record_t *record);
+
+/**
+ * Finaliza o cabeçalho do lote
+ *
+ * @param encoder Codificador
+ * @return Tamanho do lote em bytes
+ */
+uint32_t telemetry_encoder_finish(telemetry_encoder_t *encoder);
+
+/**
+ * Decodifica um lote (lado do receptor)
+ *
+ * @param buffer Lote
+ * @param length Tamanho do lote em bytes
+ * @param records Destino dos registros
+ * @param max_records Capacidade do destino
+ * @param count Número de registros decodificados
+ * @return TELEMETRY_OK, TELEMETRY_ERROR_FORMAT ou TELEMETRY_ERROR_SPACE
+ */
+int telemetry_decode(const uint8_t *buffer, uint32_t length, telemetry_record_t *records, uint32_t max_records,
+                     uint32_t *count);
+
+/**
+ * Codifica um retrato de métricas
+ *
+ * Formato: cabeçalho 'S', 'M', versão e número de contadores, seguido de
+ * varints sem sinal com o tempo desde a partida, o tempo ocioso de cada
+ * núcleo, a carga estimada e os contadores na ordem de metrics_counter_t.
+ * O retrato inteiro costuma caber em 30 a 50 bytes.
+ *
+ * @param snapshot Retrato obtido com metrics_snapshot()
+ * @param buffer Destino (TELEMETRY_METRICS_MAX_ENCODED bytes bastam)
+ * @param capacity Tamanho do destino
+ * @return Tamanho codificado em bytes, ou 0 se não couber
+ */
+uint32_t telemetry_encode_metrics(const metrics_snapshot_t *snapshot, uint8_t *buffer, uint32_t capacity);
+
+/**
+ * Decodifica um retrato de métricas (lado do receptor)
+ *
+ * Contadores desconhecidos, gravados por um firmware mais novo, são
+ * ignorados; os ausentes ficam em zero. A ocupação dos núcleos é
+ * recalculada a partir dos tempos.
+ *
+ * @param buffer Retrato codificado
+ * @param length Tamanho em bytes
+ * @param snapshot Destino
+ * @return TELEMETRY_OK ou TELEMETRY_ERROR_FORMAT
+ */
+int telemetry_decode_metrics(const uint8_t *buffer, uint32_t length, metrics_snapshot_t *snapshot);
+
+#endif
@@ -0,0 +1,106 @@
+#include "trace.h"
+
+#if SMART_BAG_TRACE
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/structs/systick.h"
+#include "hardware/sync.h"
+
+#define TRACE_MASK (TRACE_CAPACITY - 1)
+#define TRACE_SYSTICK_MAX 0x00FFFFFFu   // Recarga máxima do SysTick (24 bits)
+#define TRACE_SYSTICK_ENABLE_CPU 0x5u   // CSR: ENABLE | CLKSOURCE (clock do processador), sem interrupção
+
+_Static_assert((TRACE_CAPACITY & TRACE_MASK) == 0, "TRACE_CAPACITY deve ser potência de 2");
+
+// Anel de eventos de um núcleo
+typedef struct {
+    volatile uint32_t head;      // Total de eventos gravados
+    trace_entry_t entries[TRACE_CAPACITY];
+} trace_ring_t;
+
+static trace_ring_t trace_rings[2];
+static volatile bool trace_paused;
+
+// Nomes impressos por trace_dump(), indexados por trace_event_t
+static const char *const trace_event_names[TRACE_EVENT_COUNT] = {
+    [TRACE_DHT22_READ_BEGIN] = "dht22_read_begin",
+    [TRACE_DHT22_READ_END] = "dht22_read_end",
+    [TRACE_DHT22_START_LOW] = "dht22_start_low",
+    [TRACE_DHT22_START_RELEASE] = "dht22_start_release",
+    [TRACE_DHT22_RESPONSE] = "dht22_response",
+    [TRACE_DHT22_DATA] = "dht22_data",
+    [TRACE_DHT22_PIO_START] = "dht22_pio_start",
+    [TRACE_DHT22_PIO_FINISH] = "dht22_pio_finish",
+    [TRACE_HX711_READ_BEGIN] = "hx711_read_begin",
+    [TRACE_HX711_READ_READY] = "hx711_read_ready",
+    [TRACE_HX711_READ_END] = "hx711_read_end",
+};
+
+// Habilita o SysTick do núcleo atual como contador livre
+void trace_init(void) {
+    systick_hw->csr = 0;
+    systick_hw->rvr = TRACE_SYSTICK_MAX;
+    systick_hw->cvr = 0;
+    systick_hw->csr = TRACE_SYSTICK_ENABLE_CPU;
+}
+
+// Grava um evento no anel do núcleo atual
+void trace_record(trace_event_t event, int16_t arg) {
+    if (trace_paused) {
+        return;
+    }
+
+    trace_ring_t *ring = &trace_rings[get_core_num()];
+
+    // Alarmes do DHT22 também gravam eventos: uma interrupção no próprio
+    // núcleo não pode reutilizar a posição entre a leitura e a escrita de head
+    uint32_t irq = save_and_disable_interrupts();
+    uint32_t head = ring->head;
+    trace_entry_t *entry = &ring->entries[head & TRACE_MASK];
+
+    entry->cycles = systick_hw->cvr;
+    entry->time_us = time_us_32();
+    entry->event = (uint16_t)event;
+    entry->arg = arg;
+    ring->head = head + 1;
+    restore_interrupts(irq);
+}
+
+// Imprime e esvazia os anéis
+void trace_dump(void) {
+    trace_paused = true;
+    __mem_fence_release();
+
+    // Eventos já iniciados no outro núcleo terminam em poucos ciclos
+    busy_wait_us_32(10);
+
+    for (uint32_t core = 0; core < count_of(trace_rings); core++) {
+        trace_ring_t *ring = &trace_rings[core];
+        uint32_t head = ring->head;
+        uint32_t count = head < TRACE_CAPACITY ? head : TRACE_CAPACITY;
+
+        printf("trace core%lu: %lu eventos (%lu perdidos)\n", (unsigned long)core,
+               (unsigned long)count, (unsigned long)(head - count));
+
+        const trace_entry_t *previous = NULL;
+        for (uint32_t i = head - count; i != head; i++) {
+            const trace_entry_t *entry = &ring->entries[i & TRACE_MASK];
+            const char *name = entry->event < TRACE_EVENT_COUNT ? trace_event_names[entry->event] : "?";
+
+            // SysTick é decrescente: ciclos decorridos = anterior - atual (módulo 2^24)
+            uint32_t delta_cycles = previous ? (previous->cycles - entry->cycles) & TRACE_SYSTICK_MAX : 0;
+            uint32_t delta_us = previous ? entry->time_us - previous->time_us : 0;
+
+            printf("%10lu us +%-7lu us %8lu cyc %-20s %d\n", (unsigned long)entry->time_us, (unsigned long)delta_us,
+                   (unsigned long)delta_cycles, name, entry->arg);
+            previous = entry;
+        }
+        ring->head = 0;
+    }
+
+    __mem_fence_release();
+    trace_paused = false;
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+// Instrumentação dos caminhos críticos (habilitada pela opção SMART_BAG_TRACE do CMake)
+#ifndef SMART_BAG_TRACE
+#define SMART_BAG_TRACE 0
+#endif
+
+// Entradas do anel de cada núcleo (potência de 2)
+#ifndef TRACE_CAPACITY
+#define TRACE_CAPACITY 256
+#endif
+
+// Pontos instrumentados
+typedef enum {
+    TRACE_DHT22_READ_BEGIN,      // Início de dht22_read() (arg = pino)
+    TRACE_DHT22_READ_END,        // Fim de dht22_read() (arg = código de retorno)
+    TRACE_DHT22_START_LOW,       // Linha forçada em LOW (arg = duração em µs)
+    TRACE_DHT22_START_RELEASE,   // Linha liberada para a resposta
+    TRACE_DHT22_RESPONSE,        // Fim da espera pela resposta (arg = código de retorno)
+    TRACE_DHT22_DATA,            // Fim da medição dos 40 pulsos (arg = código de retorno)
+    TRACE_DHT22_PIO_START,       // Captura disparada no PIO
+    TRACE_DHT22_PIO_FINISH,      // Captura PIO encerrada (arg = código de retorno)
+    TRACE_HX711_READ_BEGIN,      // Início de hx711_read()
+    TRACE_HX711_READ_READY,      // Conversão disponível na RX FIFO (arg = nível da FIFO)
+    TRACE_HX711_READ_END,        // Fim de hx711_read() (arg = 0 ok, 1 erro)
+    TRACE_EVENT_COUNT
+} trace_event_t;
+
+/**
+ * Entrada do anel de rastreamento.
+ *
+ * time_us dá a referência absoluta; cycles é o valor do SysTick do núcleo
+ * (contador decrescente de 24 bits no clock do processador), preciso ao
+ * ciclo para medir intervalos curtos entre entradas consecutivas.
+ */
+typedef struct {
+    uint32_t time_us;            // time_us_32() no momento do evento
+    uint32_t cycles;             // SysTick (decrescente, 24 bits)
+    uint16_t event;              // trace_event_t
+    int16_t arg;                 // Argumento do evento
+} trace_entry_t;
+
+#if SMART_BAG_TRACE
+
+/**
+ * Habilita o SysTick do núcleo que chama esta função como contador livre
+ *
+ * Deve ser chamada uma vez em cada núcleo que grava eventos.
+ */
+void trace_init(void);
+
+/**
+ * Grava um evento no anel do núcleo atual
+ *
+ * Sem travas: cada núcleo escreve apenas no próprio anel. Com o anel cheio,
+ * as entradas mais antigas são sobrescritas.
+ *
+ * @param event Ponto instrumentado
+ * @param arg Argumento do evento
+ */
+void trace_record(trace_event_t event, int16_t arg);
+
+/**
+ * Imprime o conteúdo dos anéis pela saída padrão (USB/UART) e os esvazia
+ *
+ * A gravação é suspensa durante a impressão.
+ */
+void trace_dump(void);
+
+#define TRACE(event, arg) trace_record((event), (int16_t)(arg))
+
+#else
+
+// Compilado sem instrumentação: nenhuma instrução é gerada
+static inline void trace_init(void) {}
+static inline void trace_dump(void) {}
+#define TRACE(event, arg) ((void)0)
+
+#endif
+
+#endif
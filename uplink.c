@@ -0,0 +1,172 @@
+#include "uplink.h"
+#include "flash_log.h"
+#include "metrics.h"
+#include "telemetry.h"
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+#include "lwip/ip_addr.h"
+#include "lwip/pbuf.h"
+#include "lwip/udp.h"
+#include <string.h>
+
+#define UPLINK_ACK_TIMEOUT_MS 250        // Espera pela confirmação de cada lote
+#define UPLINK_ACK_ATTEMPTS 4            // Envios de um lote antes de desistir da conexão
+
+// Confirmação recebida do receptor (callback do lwIP)
+static volatile bool uplink_acked;
+static volatile uint32_t uplink_acked_seq;
+
+// Grava um inteiro de 32 bits em little-endian
+static void uplink_put_u32(uint8_t *out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+// Recebe as confirmações 'S', 'K' + sequência
+static void uplink_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port) {
+    (void)arg;
+    (void)pcb;
+    (void)addr;
+    (void)port;
+    uint8_t ack[UPLINK_HEADER_SIZE];
+
+    if (pbuf_copy_partial(p, ack, sizeof(ack), 0) == sizeof(ack) && ack[0] == UPLINK_ACK_MAGIC0 &&
+        ack[1] == UPLINK_ACK_MAGIC1) {
+        uplink_acked_seq = (uint32_t)ack[2] | (uint32_t)ack[3] << 8 | (uint32_t)ack[4] << 16 |
+                           (uint32_t)ack[5] << 24;
+        uplink_acked = true;
+    }
+    pbuf_free(p);
+}
+
+// Envia um lote como um datagrama
+static int uplink_send_datagram(struct udp_pcb *pcb, const ip_addr_t *addr, uint16_t port, const uint8_t *data,
+                                uint32_t length) {
+    err_t err = ERR_MEM;
+
+    cyw43_arch_lwip_begin();
+    struct pbuf *p = pbuf_alloc(PBUF_TRANSPORT, (u16_t)length, PBUF_RAM);
+    if (p != NULL) {
+        memcpy(p->payload, data, length);
+        err = udp_sendto(pcb, p, addr, port);
+        pbuf_free(p);
+    }
+    cyw43_arch_lwip_end();
+
+    return err == ERR_OK ? UPLINK_OK : UPLINK_ERROR_SEND;
+}
+
+// Envia um lote do log e espera a confirmação do receptor, reenviando se preciso.
+// Também cobre o primeiro datagrama da conexão, descartado enquanto o ARP resolve.
+static int uplink_send_acked(struct udp_pcb *pcb, const ip_addr_t *addr, uint16_t port, uint8_t *datagram,
+                             uint32_t length, uint32_t seq) {
+    uplink_put_u32(datagram + 2, seq);
+
+    for (int attempt = 0; attempt < UPLINK_ACK_ATTEMPTS; attempt++) {
+        uplink_acked = false;
+        int result = uplink_send_datagram(pcb, addr, port, datagram, length);
+        if (result != UPLINK_OK) {
+            return result;
+        }
+
+        absolute_time_t deadline = make_timeout_time_ms(UPLINK_ACK_TIMEOUT_MS);
+        while (!time_reached(deadline)) {
+            if (uplink_acked && uplink_acked_seq == seq) {
+                return UPLINK_OK;
+            }
+            cyw43_arch_wait_for_work_until(deadline);
+        }
+    }
+    return UPLINK_ERROR_ACK;
+}
+
+// Envia os lotes pendentes a partir do mais antigo; só os confirmados contam em pages
+static int uplink_drain_log(const uplink_config_t *config, const ip_addr_t *addr, uint32_t max_records,
+                            uint32_t *sent, uint32_t *pages) {
+    uint8_t datagram[UPLINK_HEADER_SIZE + FLASH_LOG_PAGE_PAYLOAD];
+    uint32_t length;
+    flash_log_cursor_t cursor;
+    int result = UPLINK_OK;
+
+    cyw43_arch_lwip_begin();
+    struct udp_pcb *pcb = udp_new_ip_type(IPADDR_TYPE_ANY);
+    if (pcb != NULL) {
+        udp_recv(pcb, uplink_recv, NULL);
+    }
+    cyw43_arch_lwip_end();
+    if (pcb == NULL) {
+        return UPLINK_ERROR_SEND;
+    }
+
+    datagram[0] = UPLINK_MAGIC0;
+    datagram[1] = UPLINK_MAGIC1;
+    flash_log_cursor_begin(&cursor);
+    uint32_t start = cursor.remaining;
+    while (*sent < max_records &&
+           flash_log_read(&cursor, datagram + UPLINK_HEADER_SIZE, &length) == FLASH_LOG_OK) {
+        result = uplink_send_acked(pcb, addr, config->port, datagram, UPLINK_HEADER_SIZE + length, cursor.seq);
+        if (result != UPLINK_OK) {
+            break;
+        }
+        (*sent)++;
+        *pages = start - cursor.remaining; // Inclui páginas corrompidas puladas pelo cursor
+    }
+
+    // Retrato das métricas no fim da conexão, já com os lotes deste envio
+    metrics_add(METRICS_UPLINK_BATCHES, *sent);
+    if (result == UPLINK_OK) {
+        metrics_snapshot_t snapshot;
+        uint8_t encoded[TELEMETRY_METRICS_MAX_ENCODED];
+        metrics_snapshot(&snapshot);
+        uplink_send_datagram(pcb, addr, config->port, encoded,
+                             telemetry_encode_metrics(&snapshot, encoded, sizeof(encoded)));
+    }
+
+    cyw43_arch_lwip_begin();
+    udp_remove(pcb);
+    cyw43_arch_lwip_end();
+    return result;
+}
+
+// Liga o rádio, envia os lotes pendentes e desliga o rádio
+int uplink_send_log(const uplink_config_t *config, uint32_t max_records, uint32_t *sent) {
+    ip_addr_t addr;
+    uint32_t pages = 0;
+    int result;
+
+    *sent = 0;
+    if (!ipaddr_aton(config->host, &addr)) {
+        return UPLINK_ERROR_ADDRESS;
+    }
+
+    // Lotes ainda em RAM também seguem nesta conexão
+    flash_log_flush();
+    if (flash_log_pending() == 0) {
+        return UPLINK_OK;
+    }
+
+    uint32_t radio_start = time_us_32();
+    if (cyw43_arch_init() != 0) {
+        metrics_add(METRICS_UPLINK_ERRORS, 1);
+        return UPLINK_ERROR_INIT;
+    }
+    cyw43_arch_enable_sta_mode();
+
+    if (cyw43_arch_wifi_connect_timeout_ms(config->ssid, config->password, CYW43_AUTH_WPA2_AES_PSK,
+                                           config->connect_timeout_ms) != 0) {
+        result = UPLINK_ERROR_CONNECT;
+    } else {
+        result = uplink_drain_log(config, &addr, max_records, sent, &pages);
+    }
+
+    cyw43_arch_deinit();
+    metrics_add_us(METRICS_RADIO_ON_MS, time_us_32() - radio_start);
+    if (result != UPLINK_OK) {
+        metrics_add(METRICS_UPLINK_ERRORS, 1);
+    }
+
+    // Marca os lotes confirmados de uma vez, já com o rádio desligado
+    flash_log_consume(pages);
+    return result;
+}
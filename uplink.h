@@ -0,0 +1,62 @@
+#ifndef UPLINK_H
+#define UPLINK_H
+
+#include <stdint.h>
+
+// Códigos de retorno do uplink
+#define UPLINK_OK 0                       // Envio concluído (ou nada a enviar)
+#define UPLINK_ERROR_INIT -1              // Falha ao ligar o rádio CYW43
+#define UPLINK_ERROR_CONNECT -2           // Rede não encontrada, senha recusada ou DHCP sem resposta
+#define UPLINK_ERROR_SEND -3              // lwIP recusou um datagrama
+#define UPLINK_ERROR_ADDRESS -4           // Endereço do receptor inválido
+#define UPLINK_ERROR_ACK -5               // Receptor não confirmou um lote
+
+// Datagramas de lotes: 'S', 'L', sequência do log (32 bits, little-endian) e o lote.
+// Confirmações do receptor: 'S', 'K' e a mesma sequência.
+#define UPLINK_MAGIC0 'S'
+#define UPLINK_MAGIC1 'L'
+#define UPLINK_ACK_MAGIC0 'S'
+#define UPLINK_ACK_MAGIC1 'K'
+#define UPLINK_HEADER_SIZE 6
+
+// Configuração da rede e do receptor
+typedef struct {
+    const char *ssid;            // Rede Wi-Fi (WPA2)
+    const char *password;        // Senha da rede
+    const char *host;            // Endereço IPv4 do receptor (ex.: "192.168.0.10")
+    uint16_t port;               // Porta UDP do receptor
+    uint32_t connect_timeout_ms; // Tempo máximo para associar e obter endereço
+} uplink_config_t;
+
+/**
+ * Envia os lotes pendentes do log da flash em uma única conexão
+ *
+ * Liga o rádio, associa-se à rede, envia cada lote como um datagrama UDP e
+ * desliga o rádio de novo (cyw43_arch_deinit corta a alimentação do chip).
+ * A energia para ligar o rádio e associar-se à rede é muito maior que a de
+ * transmitir alguns lotes, por isso a função deve ser chamada em intervalos
+ * de vários minutos, e não a cada amostra. Sem lotes pendentes, o rádio nem
+ * é ligado.
+ *
+ * Depois dos lotes segue um datagrama com o retrato das métricas
+ * (telemetry_encode_metrics(), cabeçalho 'S', 'M'), que inclui o tempo de
+ * rádio ligado das conexões anteriores.
+ *
+ * Cada lote leva o número de sequência da sua página no log e é reenviado
+ * até o receptor responder com uma confirmação com a mesma sequência
+ * (UPLINK_ACK_MAGIC0, UPLINK_ACK_MAGIC1). Só os lotes confirmados são
+ * marcados como consumidos; sem confirmação, a conexão termina e os
+ * restantes são enviados na próxima chamada. O receptor deve descartar
+ * sequências repetidas, já que uma confirmação perdida faz o lote ser
+ * reenviado. A chamada bloqueia o núcleo por alguns segundos durante a
+ * associação.
+ *
+ * @param config Rede e receptor
+ * @param max_records Número máximo de lotes por conexão
+ * @param sent Lotes confirmados pelo receptor
+ * @return UPLINK_OK, UPLINK_ERROR_INIT, UPLINK_ERROR_CONNECT,
+ *         UPLINK_ERROR_SEND, UPLINK_ERROR_ACK ou UPLINK_ERROR_ADDRESS
+ */
+int uplink_send_log(const uplink_config_t *config, uint32_t max_records, uint32_t *sent);
+
+#endif
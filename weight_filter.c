@@ -0,0 +1,176 @@
+#include "weight_filter.h"
+#include "hx711.h"
+#include <string.h>
+
+// Posição em que value deve ser inserido para manter sorted[0..count) em ordem
+static uint32_t weight_filter_lower_bound(const int32_t *sorted, uint32_t count, int32_t value) {
+    uint32_t low = 0;
+    uint32_t high = count;
+    
+    while (low < high) {
+        uint32_t mid = (low + high) / 2;
+        if (sorted[mid] < value) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Atualiza a janela ordenada: remove a amostra mais antiga e insere a nova
+static void weight_filter_median_insert(weight_filter_t *filter, int32_t oldest, int32_t sample, bool full) {
+    uint32_t count = filter->count;
+    
+    if (full) {
+        uint32_t pos = weight_filter_lower_bound(filter->sorted, count, oldest);
+        memmove(&filter->sorted[pos], &filter->sorted[pos + 1], (count - pos - 1) * sizeof(int32_t));
+        count--;
+    }
+    uint32_t pos = weight_filter_lower_bound(filter->sorted, count, sample);
+    memmove(&filter->sorted[pos + 1], &filter->sorted[pos], (count - pos) * sizeof(int32_t));
+    filter->sorted[pos] = sample;
+}
+
+// Inicializa um filtro
+int weight_filter_init(weight_filter_t *filter, weight_filter_type_t type, uint32_t param) {
+    memset(filter, 0, sizeof(*filter));
+    filter->type = type;
+    
+    switch (type) {
+    case WEIGHT_FILTER_MOVING_AVERAGE:
+    case WEIGHT_FILTER_MEDIAN:
+        if (param < 1 || param > WEIGHT_FILTER_MAX_WINDOW) {
+            return WEIGHT_FILTER_ERROR_INVALID_PARAM;
+        }
+        filter->window = param;
+        break;
+    case WEIGHT_FILTER_IIR:
+        if (param > WEIGHT_FILTER_IIR_MAX_SHIFT) {
+            return WEIGHT_FILTER_ERROR_INVALID_PARAM;
+        }
+        filter->shift = param;
+        break;
+    default:
+        return WEIGHT_FILTER_ERROR_INVALID_PARAM;
+    }
+    
+    return WEIGHT_FILTER_OK;
+}
+
+// Descarta o histórico do filtro
+void weight_filter_reset(weight_filter_t *filter) {
+    filter->count = 0;
+    filter->head = 0;
+    filter->sum = 0;
+    filter->acc = 0;
+    filter->value = 0;
+}
+
+// Adiciona uma amostra e retorna a nova estimativa
+int32_t weight_filter_update(weight_filter_t *filter, int32_t sample) {
+    if (filter->type == WEIGHT_FILTER_IIR) {
+        int32_t scaled = sample * (1 << WEIGHT_FILTER_IIR_FRAC_BITS);
+        if (filter->count == 0) {
+            filter->acc = scaled; // Parte da primeira amostra, sem rampa a partir de zero
+            filter->count = 1;
+        } else {
+            filter->acc += (scaled - filter->acc) >> filter->shift;
+        }
+        filter->value = filter->acc >> WEIGHT_FILTER_IIR_FRAC_BITS;
+        return filter->value;
+    }
+    
+    // Anel cronológico comum à média e à mediana
+    bool full = filter->count == filter->window;
+    int32_t oldest = filter->ring[filter->head];
+    filter->ring[filter->head] = sample;
+    filter->head = (filter->head + 1 == filter->window) ? 0 : filter->head + 1;
+    
+    if (filter->type == WEIGHT_FILTER_MOVING_AVERAGE) {
+        filter->sum += sample - (full ? oldest : 0);
+        if (!full) filter->count++;
+        filter->value = (int32_t)(filter->sum / (int32_t)filter->count);
+    } else {
+        weight_filter_median_insert(filter, oldest, sample, full);
+        if (!full) filter->count++;
+        uint32_t mid = filter->count / 2;
+        if (filter->count & 1) {
+            filter->value = filter->sorted[mid];
+        } else {
+            filter->value = (int32_t)(((int64_t)filter->sorted[mid - 1] + filter->sorted[mid]) / 2);
+        }
+    }
+    
+    return filter->value;
+}
+
+// Última estimativa
+int32_t weight_filter_value(const weight_filter_t *filter) {
+    return filter->value;
+}
+
+// Inicializa o detector de estabilidade
+void weight_settle_init(weight_settle_t *settle, int32_t tolerance, uint32_t min_samples) {
+    settle->tolerance = tolerance;
+    settle->min_samples = min_samples > 0 ? min_samples : 1;
+    weight_settle_reset(settle);
+}
+
+// Descarta a sequência atual
+void weight_settle_reset(weight_settle_t *settle) {
+    settle->run = 0;
+    settle->run_min = 0;
+    settle->run_max = 0;
+    settle->value = 0;
+    settle->stable = false;
+}
+
+// Registra uma nova estimativa filtrada
+bool weight_settle_update(weight_settle_t *settle, int32_t estimate) {
+    settle->value = estimate;
+    
+    if (settle->run == 0) {
+        settle->run_min = estimate;
+        settle->run_max = estimate;
+    } else {
+        int32_t run_min = estimate < settle->run_min ? estimate : settle->run_min;
+        int32_t run_max = estimate > settle->run_max ? estimate : settle->run_max;
+        if ((int64_t)run_max - run_min > settle->tolerance) {
+            // Faixa excedida: a sequência recomeça nesta estimativa
+            settle->run = 0;
+            run_min = estimate;
+            run_max = estimate;
+        }
+        settle->run_min = run_min;
+        settle->run_max = run_max;
+    }
+    settle->run++;
+    
+    settle->stable = settle->run >= settle->min_samples;
+    return settle->stable;
+}
+
+// Valor estável
+int32_t weight_settle_value(const weight_settle_t *settle) {
+    return (int32_t)(((int64_t)settle->run_min + settle->run_max) / 2);
+}
+
+// Lê o HX711 até o peso estabilizar
+int weight_read_stable(uint32_t gpio_dt, uint32_t gpio_sck, weight_filter_t *filter,
+                       weight_settle_t *settle, uint32_t max_samples, int32_t *reading) {
+    for (uint32_t i = 0; i < max_samples; i++) {
+        int32_t raw = hx711_read(gpio_dt, gpio_sck);
+        if (raw == HX711_READ_ERROR) {
+            return WEIGHT_FILTER_ERROR_READ;
+        }
+        
+        if (weight_settle_update(settle, weight_filter_update(filter, raw))) {
+            *reading = weight_settle_value(settle);
+            return WEIGHT_FILTER_OK;
+        }
+    }
+    
+    *reading = weight_filter_value(filter);
+    return WEIGHT_FILTER_ERROR_NOT_SETTLED;
+}
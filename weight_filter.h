@@ -0,0 +1,157 @@
+#ifndef WEIGHT_FILTER_H
+#define WEIGHT_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Códigos de retorno para as operações do filtro
+#define WEIGHT_FILTER_OK 0                  // Operação bem-sucedida
+#define WEIGHT_FILTER_ERROR_INVALID_PARAM -1 // Janela ou constante fora da faixa suportada
+#define WEIGHT_FILTER_ERROR_NOT_SETTLED -2  // Limite de amostras atingido sem estabilizar
+#define WEIGHT_FILTER_ERROR_READ -3         // Falha na leitura do HX711
+
+// Maior janela suportada pela média móvel e pela mediana
+#define WEIGHT_FILTER_MAX_WINDOW 32
+
+// Bits fracionários do acumulador do IIR. As leituras de 24 bits, deslocadas
+// por esses bits, ainda cabem em int32_t.
+#define WEIGHT_FILTER_IIR_FRAC_BITS 7
+
+// Maior deslocamento do IIR (alfa = 1/2^shift)
+#define WEIGHT_FILTER_IIR_MAX_SHIFT 8
+
+// Tipos de filtro disponíveis
+typedef enum {
+    WEIGHT_FILTER_MOVING_AVERAGE,  // Média das últimas N amostras, O(1) por amostra
+    WEIGHT_FILTER_MEDIAN,          // Mediana das últimas N amostras, rejeita picos
+    WEIGHT_FILTER_IIR              // Passa-baixas exponencial, O(1) e sem janela
+} weight_filter_type_t;
+
+/**
+ * Estado de um filtro incremental para leituras brutas do HX711.
+ *
+ * Fica entre hx711_read() e calculate_weight_mg(): recebe contagens brutas e
+ * devolve contagens filtradas. Cada amostra nova gera uma nova estimativa sem
+ * percorrer a janela novamente. A memória é do chamador; os campos são
+ * internos ao módulo.
+ */
+typedef struct {
+    weight_filter_type_t type;               // Tipo do filtro
+    uint32_t window;                         // Tamanho da janela (média/mediana)
+    uint32_t shift;                          // Deslocamento do IIR (alfa = 1/2^shift)
+    uint32_t count;                          // Amostras atualmente na janela
+    uint32_t head;                           // Próxima posição do anel cronológico
+    int64_t sum;                             // Soma da janela (média móvel)
+    int32_t acc;                             // Acumulador do IIR em ponto fixo
+    int32_t value;                           // Última estimativa
+    int32_t ring[WEIGHT_FILTER_MAX_WINDOW];  // Amostras em ordem de chegada
+    int32_t sorted[WEIGHT_FILTER_MAX_WINDOW];// Mesmas amostras ordenadas (mediana)
+} weight_filter_t;
+
+/**
+ * Inicializa um filtro
+ *
+ * @param filter Filtro a inicializar
+ * @param type Tipo do filtro
+ * @param param Tamanho da janela (1..WEIGHT_FILTER_MAX_WINDOW) para média e
+ *              mediana, ou deslocamento (0..WEIGHT_FILTER_IIR_MAX_SHIFT) para o IIR
+ * @return WEIGHT_FILTER_OK ou WEIGHT_FILTER_ERROR_INVALID_PARAM
+ */
+int weight_filter_init(weight_filter_t *filter, weight_filter_type_t type, uint32_t param);
+
+/**
+ * Descarta o histórico do filtro (por exemplo, após uma nova tara)
+ *
+ * @param filter Filtro a reiniciar
+ */
+void weight_filter_reset(weight_filter_t *filter);
+
+/**
+ * Adiciona uma amostra e retorna a nova estimativa
+ *
+ * Enquanto a janela não estiver cheia, a estimativa usa as amostras já
+ * recebidas, e o IIR parte da primeira amostra em vez de zero. Assim a
+ * primeira estimativa sai já na primeira leitura.
+ *
+ * @param filter Filtro inicializado
+ * @param sample Leitura bruta do sensor
+ * @return Leitura filtrada
+ */
+int32_t weight_filter_update(weight_filter_t *filter, int32_t sample);
+
+/**
+ * @param filter Filtro inicializado
+ * @return Última estimativa calculada por weight_filter_update()
+ */
+int32_t weight_filter_value(const weight_filter_t *filter);
+
+/**
+ * Detector de peso estável.
+ *
+ * Acompanha a variação das estimativas filtradas e declara o peso estável
+ * assim que as últimas min_samples estimativas ficam todas dentro de uma
+ * faixa de largura tolerance. A atualização é O(1): basta o mínimo e o
+ * máximo da sequência atual, que recomeça sempre que a faixa é excedida.
+ */
+typedef struct {
+    int32_t tolerance;           // Largura máxima da faixa (mesma unidade das estimativas)
+    uint32_t min_samples;        // Estimativas consecutivas exigidas dentro da faixa
+    uint32_t run;                // Estimativas na sequência atual
+    int32_t run_min;             // Menor estimativa da sequência atual
+    int32_t run_max;             // Maior estimativa da sequência atual
+    int32_t value;               // Última estimativa recebida
+    bool stable;                 // Estado atual do detector
+} weight_settle_t;
+
+/**
+ * Inicializa o detector de estabilidade
+ *
+ * @param settle Detector a inicializar
+ * @param tolerance Variação máxima aceita (ex.: contagens brutas ou mg)
+ * @param min_samples Estimativas consecutivas dentro da tolerância (mínimo 1)
+ */
+void weight_settle_init(weight_settle_t *settle, int32_t tolerance, uint32_t min_samples);
+
+/**
+ * Descarta a sequência atual (por exemplo, ao detectar movimento)
+ *
+ * @param settle Detector a reiniciar
+ */
+void weight_settle_reset(weight_settle_t *settle);
+
+/**
+ * Registra uma nova estimativa filtrada
+ *
+ * @param settle Detector inicializado
+ * @param estimate Estimativa vinda de weight_filter_update()
+ * @return true se o peso estiver estável
+ */
+bool weight_settle_update(weight_settle_t *settle, int32_t estimate);
+
+/**
+ * @param settle Detector inicializado
+ * @return Valor estável: ponto médio da faixa da sequência atual
+ */
+int32_t weight_settle_value(const weight_settle_t *settle);
+
+/**
+ * Lê o HX711 até o peso estabilizar, com término antecipado
+ *
+ * Cada leitura passa pelo filtro e pelo detector. A função retorna assim que
+ * o detector declarar estabilidade, sem esperar um número fixo de amostras,
+ * o que reduz o tempo até o resultado e o tempo em que o HX711 precisa ficar
+ * ligado. O filtro e o detector devem ser reiniciados pelo chamador quando o
+ * histórico não for mais válido.
+ *
+ * @param gpio_dt Pino de dados conectado ao DOUT do HX711
+ * @param gpio_sck Pino de clock conectado ao SCK do HX711
+ * @param filter Filtro aplicado às leituras brutas
+ * @param settle Detector de estabilidade (tolerância em contagens brutas)
+ * @param max_samples Limite de leituras antes de desistir
+ * @param reading Recebe a leitura bruta estável (ou a última estimativa, se não estabilizar)
+ * @return WEIGHT_FILTER_OK, WEIGHT_FILTER_ERROR_NOT_SETTLED ou WEIGHT_FILTER_ERROR_READ
+ */
+int weight_read_stable(uint32_t gpio_dt, uint32_t gpio_sck, weight_filter_t *filter,
+                       weight_settle_t *settle, uint32_t max_samples, int32_t *reading);
+
+#endif